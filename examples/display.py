@@ -31,9 +31,13 @@ class Display(framebuf.FrameBuffer):
         title="MicroPython",
         window_flags=sdl2.SDL_WINDOW_SHOWN,
         render_flags=sdl2.SDL_RENDERER_ACCELERATED,
+        format=framebuf.RGB565,
+        auto_dirty=False,
+        threaded=False,
+        keycodes=False,
+        mouse_touch=False,
+        auto_pause=False,
     ):
-        self.buffer = bytearray(width * height * 2)
-
         self.width = width
         self.height = height
         self.display = sdl2.SDL2(
@@ -46,22 +50,110 @@ class Display(framebuf.FrameBuffer):
             title=title,
             window_flags=window_flags,
             render_flags=render_flags,
+            format=format,
+            auto_dirty=auto_dirty,
+            threaded=threaded,
+            keycodes=keycodes,
+            mouse_touch=mouse_touch,
+            auto_pause=auto_pause,
         )
 
-        super().__init__(self.buffer, width, height, framebuf.RGB565)
+        # draw directly into the buffer owned by the SDL2 object
+        super().__init__(self.display, width, height, format)
 
-    def show(self):
-        """show the buffer on the display"""
-        self.display.show(self.buffer)
+    def show(self, rect=None):
+        """show the buffer, or only the (x, y, w, h) rect(s) of it, on the display"""
+        self.display.show(None, rect)
 
     def save(self, file_name):
         """save the buffer to a BMP """
-        self.display.save(self.buffer, file_name)
+        self.display.save(self.display, file_name)
+
+    def last_present_time(self):
+        """return the time.ticks_us() value when the last frame was presented"""
+        return self.display.last_present_time()
 
     def poll_event(self):
         """poll for a SDL_Event and return it"""
         return self.display.poll_event()
 
+    def wait_event(self, timeout=-1):
+        """wait for a SDL_Event and return it, None if the timeout expired"""
+        return self.display.wait_event(timeout)
+
+    def poll_events(self, max=64, coalesce=False):
+        """return a list of all pending SDL_Events"""
+        return self.display.poll_events(max, coalesce=coalesce)
+
+    def poll_into(self, buffer):
+        """write pending SDL_Events into buffer, return the number written"""
+        return self.display.poll_into(buffer)
+
+    def push_event(self, event_type, *items):
+        """add a SDL_Event to the queue"""
+        return self.display.push_event(event_type, *items)
+
+    def push_events(self, buffer, count=None):
+        """add the first count SDL_Event records in buffer to the queue"""
+        return self.display.push_events(buffer, count)
+
+    def keyboard_state(self):
+        """return a memoryview of the pressed state of each scancode"""
+        return self.display.keyboard_state()
+
+    def mouse_state(self):
+        """return the (x, y, buttons) state of the mouse"""
+        return self.display.mouse_state()
+
+    def set_event_filter(self, types=None):
+        """only queue SDL_Events of the given types, None to restore the defaults"""
+        self.display.set_event_filter(types)
+
+    def open_controller(self, index=0):
+        """open a game controller, return its instance id"""
+        return self.display.open_controller(index)
+
+    def close_controller(self, which):
+        """close a game controller opened by open_controller"""
+        self.display.close_controller(which)
+
+    def controller_state(self, which, buffer=None):
+        """return the axes followed by the buttons of a game controller"""
+        return self.display.controller_state(which, buffer)
+
+    def start_text_input(self):
+        """start receiving SDL_TEXTINPUT events"""
+        self.display.start_text_input()
+
+    def stop_text_input(self):
+        """stop receiving SDL_TEXTINPUT events"""
+        self.display.stop_text_input()
+
+    def record_events(self, file_name=None):
+        """record the SDL_Events polled to a file, None to stop"""
+        self.display.record_events(file_name)
+
+    def replay_events(self, file_name=None):
+        """replay SDL_Events recorded by record_events, None to stop"""
+        self.display.replay_events(file_name)
+
+    # pylint: disable=import-outside-toplevel
+    async def next_event(self):
+        """wait for a SDL_Event without blocking other asyncio tasks"""
+        from asyncio import core
+
+        while not (event := self.display.poll_event()):
+            yield core._io_queue.queue_read(self.display)
+        return event
+
+    async def present(self, rect=None):
+        """show the buffer and wait for the frame to be presented"""
+        from asyncio import core
+
+        self.display.show(None, rect)
+        while not self.display.wait_idle(0):
+            yield core._io_queue.queue_write(self.display)
+
     def deinit(self):
         """deinitialize the display"""
         self.display.deinit()
@@ -48,6 +48,9 @@ def main():
     # create a display instance
     tft = display.Display(WIDTH, HEIGHT, x_scale=3, y_scale=2, title="Feathers")
 
+    # only SDL_QUIT is handled, drop all other events in SDL
+    tft.set_event_filter((sdl2.SDL_QUIT,))
+
     scroll = 0  # scroll position
     wheel = 0  # color wheel position
 
@@ -43,8 +43,8 @@ def main():
     p_y = 0
 
     while True:
-        # check for an event
-        event = tft.poll_event()
+        # sleep until there is an event
+        event = tft.wait_event()
 
         # if no events, continue
         if not event:
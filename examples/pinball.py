@@ -785,25 +785,16 @@ def start_game():
             while table.game_over is False:
                 last = time.ticks_ms()
 
-                # check the event queue for mouse button events or quit.
+                # check the event queue for quit.
                 while event := tft.poll_event():
-                    if event[sdl2.TYPE] == sdl2.SDL_MOUSEBUTTONDOWN:
-                        if event[sdl2.BUTTON] == sdl2.SDL_BUTTON_LEFT:
-                            table.flippers[0].pressed = True
-
-                        if event[sdl2.BUTTON] == sdl2.SDL_BUTTON_RIGHT:
-                            table.flippers[1].pressed = True
-
-                    elif event[sdl2.TYPE] == sdl2.SDL_MOUSEBUTTONUP:
-                        if event[sdl2.BUTTON] == sdl2.SDL_BUTTON_LEFT:
-                            table.flippers[0].pressed = False
-
-                        if event[sdl2.BUTTON] == sdl2.SDL_BUTTON_RIGHT:
-                            table.flippers[1].pressed = False
-
-                    elif event[sdl2.TYPE] == sdl2.SDL_QUIT:
+                    if event[sdl2.TYPE] == sdl2.SDL_QUIT:
                         return
 
+                # the mouse buttons work the flippers
+                buttons = tft.mouse_state()[2]
+                table.flippers[0].pressed = bool(buttons & sdl2.SDL_BUTTON_LMASK)
+                table.flippers[1].pressed = bool(buttons & sdl2.SDL_BUTTON_RMASK)
+
                 table.simulate()
 
                 table.draw_border()
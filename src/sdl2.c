@@ -1,10 +1,15 @@
 // Include MicroPython API.
 #include "py/runtime.h"
 #include "py/mphal.h"
+#include "py/stream.h"
+#include "py/mperrno.h"
+#include "py/objarray.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <math.h>
+#include <errno.h>
 
 #include <SDL2/SDL.h>
 
@@ -13,6 +18,29 @@
 #define COLOR565_G (0x07e0)
 #define COLOR565_B (0x001f)
 
+// game controllers that can be open at the same time
+#define SDL2_MAX_CONTROLLERS (4)
+
+// record_events() file entry, the file starts with SDL2_EVENTS_MAGIC
+typedef struct _sdl2_event_entry_t {
+    uint32_t frame;         // show() calls since recording started
+    SDL_Event event;
+} sdl2_event_entry_t;
+
+#define SDL2_EVENTS_MAGIC "SDL2EVT1"
+
+// framebuf pixel formats, the values match the framebuf module constants
+#define FRAMEBUF_MVLSB    (0)
+#define FRAMEBUF_RGB565   (1)
+#define FRAMEBUF_GS4_HMSB (2)
+#define FRAMEBUF_MHLSB    (3)
+#define FRAMEBUF_MHMSB    (4)
+#define FRAMEBUF_GS2_HMSB (5)
+#define FRAMEBUF_GS8      (6)
+
+// palette entry format for set_palette, not a framebuf format
+#define PALETTE_RGB888    (7)
+
 typedef struct _sdl2_obj_t
 {
 	mp_obj_base_t base;
@@ -26,337 +54,2612 @@ typedef struct _sdl2_obj_t
     int render_flags;       // render flags
     int x_scale;            // x scale of the window
     int y_scale;            // y scale of the window
+    int format;             // framebuf format of the buffer
+    bool convert;           // convert RGB565 to ARGB8888 on the CPU before upload
+    bool swap_bytes;        // buffer holds byte-swapped (big-endian) RGB565
+    bool auto_dirty;        // find the changed areas of the buffer by comparing with shadow
+    bool threaded;          // upload and present from a render thread
+    bool keycodes;          // key events hold the keycode and scancode instead of the key name
+    bool mouse_touch;       // SDL synthesizes touch events from the mouse
+    bool auto_pause;        // skip show() while the window is hidden or minimized
 
 	SDL_Window *win;
 	SDL_Renderer *renderer;
+    SDL_Texture *texture;   // streaming texture the buffer is uploaded to
+    Uint32 texture_format;  // SDL_PIXELFORMAT_RGB565 or SDL_PIXELFORMAT_ARGB8888
+
+    uint32_t rgb565_lut[2][256];    // ARGB8888 contributions of the low and high RGB565 bytes
+    uint32_t index_lut[256];        // ARGB8888 color of each pixel value of the packed formats, the palette
+
+    uint8_t *framebuffer;   // buffer exposed by the buffer protocol, allocated outside the GC heap
+    uint8_t *shadow;        // copy of the buffer last shown when auto_dirty is set
+    bool shadow_valid;      // false if the next show() must upload the whole buffer
+    size_t uploaded;        // bytes uploaded to the texture by the last show()
+    bool busy;              // show() is running, possibly without the GIL
+    bool stale;             // show() skipped frames, the texture is out of date
+    mp_obj_t keyboard_state;    // memoryview of SDL's key state array, created on first use
+    SDL_GameController *controllers[SDL2_MAX_CONTROLLERS];   // controllers opened by open_controller()
+
+    uint32_t frames;                // show() calls, used to time recorded events
+    FILE *record_file;              // record_events() file events are written to
+    uint32_t record_start;          // frames when recording started
+    bool record_failed;             // an event could not be written, recording stopped
+    FILE *replay_file;              // replay_events() file events are read from
+    uint32_t replay_start;          // frames when replaying started
+    sdl2_event_entry_t replay_next; // next event to replay, read ahead from replay_file
+
+    SDL_Thread *render_thread;  // thread that owns the renderer when threaded is set
+    SDL_mutex *lock;            // protects staging, pending and the flags below
+    SDL_cond *cond;             // signalled when a frame is ready or the render thread goes idle
+    uint8_t *staging;           // back buffer of texture pixels filled by show()
+    SDL_Rect pending;           // area of staging not uploaded to the texture yet
+    bool frame_ready;           // show() has finished a frame the render thread has not taken
+    bool presenting;            // the render thread is uploading or presenting a frame
+    bool quit;                  // the render thread should exit
+    int thread_status;          // 0 starting, 1 running, -1 failed to create the renderer
+    char thread_error[128];     // why the render thread failed
+    bool presented;             // a frame has been presented
+    mp_uint_t present_time;     // time.ticks_us() value when the last present returned
+
+} sdl2_obj_t;
+
+// Precompute the ARGB8888 value contributed by each possible low and high
+// byte of a little-endian RGB565 pixel so conversion is two lookups and an or.
+// Channels are widened by bit replication, which keeps the bits from each byte
+// disjoint even for green, which is split across both bytes. Byte-swapped
+// buffers only need the two tables exchanged.
+
+static void sdl2_init_rgb565_lut(sdl2_obj_t *self) {
+    int lo_byte = self->swap_bytes ? 1 : 0;
+
+    for (unsigned int i = 0; i < 256; i++) {
+        unsigned int b = i & 0x1f;          // low byte: gggbbbbb
+        unsigned int g_lo = i >> 5;
+        unsigned int r = i >> 3;            // high byte: rrrrrggg
+        unsigned int g_hi = i & 0x07;
+
+        self->rgb565_lut[lo_byte][i] = (g_lo << 10) | (b << 3) | (b >> 2);
+        self->rgb565_lut[!lo_byte][i] = 0xff000000 | (((r << 3) | (r >> 2)) << 16) | (((g_hi << 5) | (g_hi >> 1)) << 8);
+    }
+}
+
+// Fill the lookup table for the mono and grayscale formats with a ramp from
+// black to white over the number of levels a pixel of the format can hold.
+
+static void sdl2_init_index_lut(sdl2_obj_t *self) {
+    unsigned int levels;
+
+    switch (self->format) {
+        case FRAMEBUF_GS2_HMSB:
+            levels = 4;
+            break;
+        case FRAMEBUF_GS4_HMSB:
+            levels = 16;
+            break;
+        case FRAMEBUF_GS8:
+            levels = 256;
+            break;
+        default:
+            levels = 2;
+            break;
+    }
+
+    for (unsigned int i = 0; i < 256; i++) {
+        unsigned int gray = i < levels ? i * 255 / (levels - 1) : 255;
+        self->index_lut[i] = 0xff000000 | (gray << 16) | (gray << 8) | gray;
+    }
+}
+
+// Size in bytes of a framebuf buffer of the display size in the object's format.
+
+static size_t sdl2_buffer_size(sdl2_obj_t *self) {
+    size_t width = self->width;
+    size_t height = self->height;
+
+    switch (self->format) {
+        case FRAMEBUF_MVLSB:
+            return width * ((height + 7) / 8);
+        case FRAMEBUF_MHLSB:
+        case FRAMEBUF_MHMSB:
+            return ((width + 7) / 8) * height;
+        case FRAMEBUF_GS2_HMSB:
+            return ((width + 3) / 4) * height;
+        case FRAMEBUF_GS4_HMSB:
+            return ((width + 1) / 2) * height;
+        case FRAMEBUF_GS8:
+            return width * height;
+        default:
+            return width * height * 2;
+    }
+}
+
+// Copy `count` RGB565 pixels exchanging the bytes of each one. The buffer may
+// be a memoryview at an odd offset, so the pixels are accessed a byte at a
+// time; the loop is still simple enough for the compiler to vectorize.
+
+static void sdl2_swap565(const uint8_t *src, uint8_t *dst, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[2 * i] = src[2 * i + 1];
+        dst[2 * i + 1] = src[2 * i];
+    }
+}
+
+// Convert the `rect` area of a framebuf buffer to texture pixels. `pixels`
+// points to the top left of the area and `pitch` is the length of a row in
+// bytes, as returned by SDL_LockTexture. The packed formats are unpacked a
+// pixel at a time using framebuf's addressing and colored by the index table.
+
+static void sdl2_convert(sdl2_obj_t *self, const uint8_t *buffer, const SDL_Rect *rect, uint8_t *pixels, int pitch) {
+    const uint32_t *lut = self->index_lut;
+    int width = self->width;
+
+    for (int y = rect->y; y < rect->y + rect->h; y++, pixels += pitch) {
+        uint32_t *row = (uint32_t *)pixels;
+        int x0 = rect->x;
+        int x1 = rect->x + rect->w;
+
+        switch (self->format) {
+            case FRAMEBUF_RGB565: {
+                const uint8_t *src = buffer + (y * width + x0) * 2;
+                if (self->texture_format == SDL_PIXELFORMAT_RGB565) {
+                    sdl2_swap565(src, pixels, rect->w);
+                    break;
+                }
+                for (int x = x0; x < x1; x++, src += 2) {
+                    *row++ = self->rgb565_lut[0][src[0]] | self->rgb565_lut[1][src[1]];
+                }
+                break;
+            }
+
+            case FRAMEBUF_GS8: {
+                const uint8_t *src = buffer + y * width + x0;
+                for (int x = x0; x < x1; x++) {
+                    *row++ = lut[*src++];
+                }
+                break;
+            }
+
+            case FRAMEBUF_GS4_HMSB: {
+                const uint8_t *src = buffer + y * ((width + 1) & ~1) / 2;
+                for (int x = x0; x < x1; x++) {
+                    *row++ = lut[(src[x >> 1] >> ((x & 1) ? 0 : 4)) & 0x0f];
+                }
+                break;
+            }
+
+            case FRAMEBUF_GS2_HMSB: {
+                const uint8_t *src = buffer + y * ((width + 3) & ~3) / 4;
+                for (int x = x0; x < x1; x++) {
+                    *row++ = lut[(src[x >> 2] >> ((x & 3) << 1)) & 0x03];
+                }
+                break;
+            }
+
+            case FRAMEBUF_MHLSB: {
+                const uint8_t *src = buffer + y * ((width + 7) & ~7) / 8;
+                for (int x = x0; x < x1; x++) {
+                    *row++ = lut[(src[x >> 3] >> (7 - (x & 7))) & 0x01];
+                }
+                break;
+            }
+
+            case FRAMEBUF_MHMSB: {
+                const uint8_t *src = buffer + y * ((width + 7) & ~7) / 8;
+                for (int x = x0; x < x1; x++) {
+                    *row++ = lut[(src[x >> 3] >> (x & 7)) & 0x01];
+                }
+                break;
+            }
+
+            case FRAMEBUF_MVLSB: {
+                const uint8_t *src = buffer + (y >> 3) * width;
+                int shift = y & 7;
+                for (int x = x0; x < x1; x++) {
+                    *row++ = lut[(src[x] >> shift) & 0x01];
+                }
+                break;
+            }
+        }
+    }
+}
+
+// Create the renderer and the streaming texture the buffer is uploaded to.
+// Returns NULL, or the name of the SDL function that failed.
+
+static const char *sdl2_create_renderer(sdl2_obj_t *self) {
+	self->renderer = SDL_CreateRenderer(self->win, -1, self->render_flags);
+	if (self->renderer == NULL) {
+		return "SDL_CreateRenderer";
+	}
+
+    // The texture is the size of the virtual display, SDL_RenderCopy stretches
+    // it to the window using nearest pixel sampling to apply x_scale and y_scale.
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    self->texture = SDL_CreateTexture(
+                        self->renderer,
+                        self->texture_format,
+                        SDL_TEXTUREACCESS_STREAMING,
+                        self->width,
+                        self->height);
+
+    if (self->texture == NULL) {
+        return "SDL_CreateTexture";
+    }
+    return NULL;
+}
+
+// Raise a RuntimeError if `failed` names a SDL function that failed.
+
+static void sdl2_check(const char *failed) {
+    if (failed) {
+        mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("%s error: %s\n"), failed, SDL_GetError());
+    }
+}
+
+// Raise if another thread is in show(), which uses the renderer, texture and
+// lookup tables without holding the GIL.
+static void sdl2_check_idle(sdl2_obj_t *self) {
+    if (self->busy) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("show already running"));
+    }
+}
+
+static void sdl2_destroy_renderer(sdl2_obj_t *self) {
+    if (self->texture) {
+        SDL_DestroyTexture(self->texture);
+        self->texture = NULL;
+    }
+    if (self->renderer) {
+        SDL_DestroyRenderer(self->renderer);
+        self->renderer = NULL;
+    }
+}
+
+// time.ticks_us() compatible reading of the high resolution clock
+static mp_uint_t sdl2_ticks_us(void) {
+    return mp_hal_ticks_us() & (MICROPY_PY_TIME_TICKS_PERIOD - 1);
+}
+
+// Render thread used when threaded is set. It owns the renderer, waits for
+// show() to finish a frame in the staging buffer, uploads the changed area
+// while holding the lock then presents without it, so show() only blocks for
+// the upload and never for vsync. Frames shown faster than they can be
+// presented are merged into the next upload.
+//
+// SDL only supports rendering from the thread that created the window, which
+// works in practice with the X11 and Windows video drivers but not with Cocoa
+// or Wayland, so the render thread is only started for the drivers it works
+// with.
+
+static int sdl2_render_thread(void *data) {
+    sdl2_obj_t *self = data;
+    const char *failed = sdl2_create_renderer(self);
+    int bpp = SDL_BYTESPERPIXEL(self->texture_format);
+    int pitch = self->width * bpp;
+
+    SDL_LockMutex(self->lock);
+
+    if (failed) {
+        SDL_snprintf(self->thread_error, sizeof(self->thread_error), "%s error: %s", failed, SDL_GetError());
+        sdl2_destroy_renderer(self);
+        self->thread_status = -1;
+        SDL_CondBroadcast(self->cond);
+        SDL_UnlockMutex(self->lock);
+        return -1;
+    }
+
+    self->thread_status = 1;
+    SDL_CondBroadcast(self->cond);
+
+    for (;;) {
+        while (!self->frame_ready && !self->quit) {
+            SDL_CondWait(self->cond, self->lock);
+        }
+        if (self->quit) {
+            break;
+        }
+
+        SDL_Rect rect = self->pending;
+        self->pending.w = 0;
+        self->pending.h = 0;
+        self->frame_ready = false;
+        self->presenting = true;
+
+        if (!SDL_RectEmpty(&rect)) {
+            SDL_UpdateTexture(self->texture, &rect, self->staging + rect.y * pitch + rect.x * bpp, pitch);
+        }
+        SDL_UnlockMutex(self->lock);
+
+        SDL_RenderCopy(self->renderer, self->texture, NULL, NULL);
+        SDL_RenderPresent(self->renderer);
+        mp_uint_t present_time = sdl2_ticks_us();
+
+        SDL_LockMutex(self->lock);
+        self->presenting = false;
+        self->presented = true;
+        self->present_time = present_time;
+        SDL_CondBroadcast(self->cond);
+    }
+
+    SDL_UnlockMutex(self->lock);
+    sdl2_destroy_renderer(self);
+    return 0;
+}
+
+static void sdl2_start_render_thread(sdl2_obj_t *self) {
+    const char *driver = SDL_GetCurrentVideoDriver();
+    if (driver == NULL || (SDL_strcmp(driver, "x11") != 0 && SDL_strcmp(driver, "windows") != 0)) {
+        mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("threaded is not supported by the %s video driver\n"), driver ? driver : "current");
+    }
+
+    self->staging = SDL_calloc(self->width * self->height, SDL_BYTESPERPIXEL(self->texture_format));
+    self->lock = SDL_CreateMutex();
+    self->cond = SDL_CreateCond();
+
+    if (self->staging == NULL || self->lock == NULL || self->cond == NULL) {
+        mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("could not allocate render thread buffers"));
+    }
+
+    self->thread_status = 0;
+    self->render_thread = SDL_CreateThread(sdl2_render_thread, "sdl2_render", self);
+    if (self->render_thread == NULL) {
+        mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_CreateThread error: %s\n"), SDL_GetError());
+    }
+
+    SDL_LockMutex(self->lock);
+    while (self->thread_status == 0) {
+        SDL_CondWait(self->cond, self->lock);
+    }
+    SDL_UnlockMutex(self->lock);
+
+    if (self->thread_status < 0) {
+        SDL_WaitThread(self->render_thread, NULL);
+        self->render_thread = NULL;
+        mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("%s\n"), self->thread_error);
+    }
+}
+
+// Stop the render thread, if running, and free what it used.
+
+static void sdl2_stop_render_thread(sdl2_obj_t *self) {
+    if (self->render_thread) {
+        SDL_LockMutex(self->lock);
+        self->quit = true;
+        SDL_CondBroadcast(self->cond);
+        SDL_UnlockMutex(self->lock);
+        SDL_WaitThread(self->render_thread, NULL);
+        self->render_thread = NULL;
+    }
+    if (self->cond) {
+        SDL_DestroyCond(self->cond);
+        self->cond = NULL;
+    }
+    if (self->lock) {
+        SDL_DestroyMutex(self->lock);
+        self->lock = NULL;
+    }
+    SDL_free(self->staging);
+    self->staging = NULL;
+}
+
+/// ### SDL2
+///
+/// ```python
+/// sdl2.SDL2(
+///     width=320,
+///     height=240,
+///     x=SDL_WINDOWPOS_CENTERED,
+///     y=SDL_WINDOWPOS_CENTERED,
+///     title="MicroPython",
+///     window_flags=SDL_WINDOW_SHOWN,
+///     render_flags=SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC,
+///     format=RGB565,
+///     convert=False,
+///     swap_bytes=False,
+///     auto_dirty=False,
+///     threaded=False,
+///     keycodes=False,
+///     mouse_touch=False,
+///     auto_pause=False)
+/// ```
+///
+/// #### Description
+/// Creates a window and renderer with the specified position, dimensions,
+/// title, flags and returns a SDL2 object.
+///
+/// #### Parameters
+/// - `width` The width of the window. Default: 320
+/// - `height` The height of the window. Default: 240
+/// - `x` The x position of the window. Default: SDL_WINDOWPOS_CENTERED
+///    - SDL_WINDOWPOS_UNDEFINED - used to indicate that you don't care what the x position is
+///    - SDL_WINDOWPOS_CENTERED - used to indicate that the window position should be centered
+///
+/// - `y` The y position of the window. Default: SDL_WINDOWPOS_CENTERED
+///    - SDL_WINDOWPOS_UNDEFINED - used to indicate that you don't care what the y position is
+///    - SDL_WINDOWPOS_CENTERED - used to indicate that the window position should be centered
+///
+/// - `x_scale` The x scale of the window. Default: 1
+/// - `y_scale` The y scale of the window. Default: 1
+/// - `title` The title of the window. Default: "MicroPython"
+/// - `window_flags` The window flags. Default: SDL_WINDOW_SHOWN
+///    - SDL_WINDOW_SHOWN - the window is visible
+///    - SDL_WINDOW_BORDERLESS - no window decoration
+///
+/// - `render_flags` The render flags. Default: SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
+///    - SDL_RENDERER_ACCELERATED - the renderer uses hardware acceleration
+///    - SDL_RENDERER_PRESENTVSYNC - present is synchronized with the refresh rate
+///
+/// - `format` The framebuf format of the buffers passed to show() and save().
+///    The values match the framebuf module constants. Default: RGB565
+///    - RGB565 - 16-bit color
+///    - GS8 - 8-bit grayscale
+///    - GS4_HMSB - 4-bit grayscale
+///    - GS2_HMSB - 2-bit grayscale
+///    - MONO_VLSB - monochrome, vertical bytes
+///    - MONO_HLSB - monochrome, horizontal bytes, bit 7 leftmost
+///    - MONO_HMSB - monochrome, horizontal bytes, bit 0 leftmost
+///
+/// - `convert` Convert a RGB565 buffer to ARGB8888 on the CPU instead of
+///    uploading it unchanged to a RGB565 texture. Default: False
+/// - `swap_bytes` A RGB565 buffer holds byte-swapped (big-endian) pixels as
+///    used by SPI display drivers such as the ST7789 and ILI9341. Default: False
+/// - `auto_dirty` Keep a copy of the last buffer shown and only upload the
+///    areas that changed when show() is called without a rect. Default: False
+/// - `threaded` Upload and present frames from a render thread. show() only
+///    converts the buffer into a back buffer and returns without waiting for
+///    the present, use wait_idle() to wait for it. Only supported by the X11
+///    and Windows video drivers. Default: False
+/// - `keycodes` SDL_KEYDOWN and SDL_KEYUP events return the integer keycode
+///    and scancode instead of the key name, see poll_event(). Default: False
+/// - `mouse_touch` The mouse also produces SDL_FINGER* touch events, for
+///    testing touch interfaces without a touch screen. Requires SDL 2.0.10.
+///    Default: False
+/// - `auto_pause` show() does nothing while the window is hidden or
+///    minimized and the last frame is presented again when the window is
+///    exposed. Requires SDL_WINDOWEVENT events to be polled. Default: False
+///
+/// #### Returns
+/// - A new SDL2 object.
+///
+/// #### Raises
+/// - RuntimeError for any SDL2 errors.
+/// - RuntimeError if threaded is set and the video driver is not supported.
+/// - ValueError if mouse_touch is set and SDL is older than 2.0.10.
+
+static mp_obj_t sdl2_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
+{
+	enum
+	{
+		ARG_width,              // The width of the window in virtual pixels
+		ARG_height,             // The height of the window in virtual pixels
+		ARG_x,                  // The x position of the window in virtual pixels
+		ARG_y,                  // The y position of the window in virtual pixels
+        ARG_x_scale,            // The x scale of the window
+        ARG_y_scale,            // The y scale of the window
+		ARG_title,              // The title of the window
+		ARG_window_flags,       // The window flags
+        ARG_render_flags,       // The render flags
+        ARG_format,             // The framebuf format of the buffer
+        ARG_convert,            // Convert to ARGB8888 before upload
+        ARG_swap_bytes,         // Buffer holds byte-swapped RGB565
+        ARG_auto_dirty,         // Only upload the changed areas of the buffer
+        ARG_threaded,           // Upload and present from a render thread
+        ARG_keycodes,           // Key events return keycodes instead of names
+        ARG_mouse_touch,        // Synthesize touch events from the mouse
+        ARG_auto_pause,         // Skip show() while the window can't be seen
+	};
+
+	static const mp_arg_t allowed_args[] = {
+		{MP_QSTR_width, MP_ARG_INT, {.u_int = 320}},
+		{MP_QSTR_height, MP_ARG_INT, {.u_int = 240}},
+		{MP_QSTR_x, MP_ARG_OBJ, {.u_int = SDL_WINDOWPOS_CENTERED}},
+		{MP_QSTR_y, MP_ARG_OBJ, {.u_int = SDL_WINDOWPOS_CENTERED}},
+        {MP_QSTR_x_scale, MP_ARG_INT, {.u_int = 1}},
+        {MP_QSTR_y_scale, MP_ARG_INT, {.u_int = 1}},
+		{MP_QSTR_title, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_QSTR(MP_QSTR_MicroPython)}},
+		{MP_QSTR_window_flags, MP_ARG_INT, {.u_int = SDL_WINDOW_SHOWN}},
+        {MP_QSTR_render_flags, MP_ARG_INT, {.u_int = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC}},
+        {MP_QSTR_format, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = FRAMEBUF_RGB565}},
+        {MP_QSTR_convert, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_swap_bytes, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_auto_dirty, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_threaded, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_keycodes, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_mouse_touch, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+        {MP_QSTR_auto_pause, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+	};
+
+	mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+	mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+	// Allocates the new object and sets the type.
+	sdl2_obj_t *self = mp_obj_malloc_with_finaliser(sdl2_obj_t, type);
+
+    // the finaliser may run on an object make_new raised part way through
+    self->win = NULL;
+    self->renderer = NULL;
+    self->texture = NULL;
+    self->framebuffer = NULL;
+    self->shadow = NULL;
+    self->render_thread = NULL;
+    self->lock = NULL;
+    self->cond = NULL;
+    self->staging = NULL;
+    self->pending = (SDL_Rect) {0, 0, 0, 0};
+    self->frame_ready = false;
+    self->presenting = false;
+    self->quit = false;
+    self->busy = false;
+    self->stale = false;
+    self->keyboard_state = MP_OBJ_NULL;
+    memset(self->controllers, 0, sizeof(self->controllers));
+    self->frames = 0;
+    self->record_file = NULL;
+    self->record_failed = false;
+    self->replay_file = NULL;
+    self->presented = false;
+
+	// store the argument values in the object
+	self->x = args[ARG_x].u_int;
+	self->y = args[ARG_y].u_int;
+	self->width = args[ARG_width].u_int;
+	self->height = args[ARG_height].u_int;
+    self->x_scale = args[ARG_x_scale].u_int;
+    self->y_scale = args[ARG_y_scale].u_int;
+	self->title = mp_obj_str_get_str(args[ARG_title].u_obj);
+	self->window_flags = args[ARG_window_flags].u_int;
+    self->render_flags = args[ARG_render_flags].u_int;
+    self->format = args[ARG_format].u_int;
+    self->convert = args[ARG_convert].u_bool;
+    self->swap_bytes = args[ARG_swap_bytes].u_bool;
+    self->auto_dirty = args[ARG_auto_dirty].u_bool;
+    self->threaded = args[ARG_threaded].u_bool;
+    self->keycodes = args[ARG_keycodes].u_bool;
+    self->mouse_touch = args[ARG_mouse_touch].u_bool;
+    #if !SDL_VERSION_ATLEAST(2, 0, 10)
+    if (self->mouse_touch) {
+        mp_raise_ValueError(MP_ERROR_TEXT("mouse_touch requires SDL 2.0.10"));
+    }
+    #endif
+    self->auto_pause = args[ARG_auto_pause].u_bool;
+
+    if (self->format < FRAMEBUF_MVLSB || self->format > FRAMEBUF_GS8) {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid format"));
+    }
+
+    // Only RGB565 buffers can be uploaded without converting them to ARGB8888.
+    if (self->format == FRAMEBUF_RGB565 && !self->convert) {
+        self->texture_format = SDL_PIXELFORMAT_RGB565;
+    } else {
+        self->texture_format = SDL_PIXELFORMAT_ARGB8888;
+    }
+
+	if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
+		mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_Init error: %s\n"), SDL_GetError());
+	}
+
+    #if SDL_VERSION_ATLEAST(2, 0, 10)
+    SDL_SetHint(SDL_HINT_MOUSE_TOUCH_EVENTS, self->mouse_touch ? "1" : "0");
+    #endif
+
+	self->win = SDL_CreateWindow(
+                    self->title,
+                    self->x,
+                    self->y,
+                    self->width * self->x_scale,
+                    self->height * self->y_scale,
+                    self->window_flags);
+
+	if (self->win == NULL) {
+		mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_CreateWindow error: %s\n"), SDL_GetError());
+	}
+
+    if (self->threaded) {
+        sdl2_start_render_thread(self);
+    } else {
+        sdl2_check(sdl2_create_renderer(self));
+    }
+
+    sdl2_init_rgb565_lut(self);
+    sdl2_init_index_lut(self);
+
+    if (self->auto_dirty) {
+        self->shadow = m_new(uint8_t, sdl2_buffer_size(self));
+    }
+    self->shadow_valid = false;
+
+	return MP_OBJ_FROM_PTR(self);
+}
+
+// Return the object's own display buffer, allocating it with SDL_calloc on
+// first use so large displays stay off the MicroPython heap.
+
+static uint8_t *sdl2_get_framebuffer(sdl2_obj_t *self) {
+    if (self->framebuffer == NULL) {
+        self->framebuffer = SDL_calloc(1, sdl2_buffer_size(self));
+        if (self->framebuffer == NULL) {
+            mp_raise_msg(&mp_type_MemoryError, MP_ERROR_TEXT("could not allocate framebuffer"));
+        }
+    }
+    return self->framebuffer;
+}
+
+// Buffer protocol, lets the SDL2 object be used as the buffer of a
+// framebuf.FrameBuffer so drawing goes straight into the display buffer.
+
+static mp_int_t sdl2_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    bufinfo->buf = sdl2_get_framebuffer(self);
+    bufinfo->len = sdl2_buffer_size(self);
+    bufinfo->typecode = 'B';
+    return 0;
+}
+
+// Upload the `rect` area of the buffer to the texture, converting it if the
+// texture can't take the buffer's format as is. Called without the GIL, so
+// returns the name of the SDL function that failed instead of raising.
+
+static const char *sdl2_upload(sdl2_obj_t *self, const uint8_t *buffer, const SDL_Rect *rect) {
+    int bpp = SDL_BYTESPERPIXEL(self->texture_format);
+    self->uploaded += rect->w * rect->h * bpp;
+
+    if (self->staging) {
+        // threaded, fill the back buffer for the render thread to upload
+        int pitch = self->width * bpp;
+        uint8_t *pixels = self->staging + rect->y * pitch + rect->x * bpp;
+
+        if (self->texture_format == SDL_PIXELFORMAT_RGB565 && !self->swap_bytes) {
+            const uint8_t *src = buffer + (rect->y * self->width + rect->x) * 2;
+            for (int y = 0; y < rect->h; y++, src += self->width * 2, pixels += pitch) {
+                memcpy(pixels, src, rect->w * 2);
+            }
+        } else {
+            sdl2_convert(self, buffer, rect, pixels, pitch);
+        }
+        SDL_UnionRect(&self->pending, rect, &self->pending);
+    } else if (self->texture_format == SDL_PIXELFORMAT_RGB565 && !self->swap_bytes) {
+        // RGB565 texture, the buffer is uploaded as is.
+        const uint8_t *src = buffer + (rect->y * self->width + rect->x) * 2;
+        if (SDL_UpdateTexture(self->texture, rect, src, self->width * 2) != 0) {
+            return "SDL_UpdateTexture";
+        }
+    } else {
+        uint8_t *pixels;
+        int pitch;
+
+        if (SDL_LockTexture(self->texture, rect, (void **)&pixels, &pitch) != 0) {
+            return "SDL_LockTexture";
+        }
+
+        sdl2_convert(self, buffer, rect, pixels, pitch);
+        SDL_UnlockTexture(self->texture);
+    }
+    return NULL;
+}
+
+// Get a (x, y, w, h) rectangle clipped to the display, returns false if
+// nothing is left of it.
+
+static bool sdl2_get_rect(sdl2_obj_t *self, mp_obj_t rect_in, SDL_Rect *rect) {
+    mp_obj_t *items;
+    mp_obj_get_array_fixed_n(rect_in, 4, &items);
+
+    int x0 = mp_obj_get_int(items[0]);
+    int y0 = mp_obj_get_int(items[1]);
+    int x1 = x0 + mp_obj_get_int(items[2]);
+    int y1 = y0 + mp_obj_get_int(items[3]);
+
+    x0 = x0 < 0 ? 0 : x0;
+    y0 = y0 < 0 ? 0 : y0;
+    x1 = x1 > self->width ? self->width : x1;
+    y1 = y1 > self->height ? self->height : y1;
+
+    rect->x = x0;
+    rect->y = y0;
+    rect->w = x1 - x0;
+    rect->h = y1 - y0;
+    return rect->w > 0 && rect->h > 0;
+}
+
+// Find the first and last bytes that differ between `a` and `b`, comparing a
+// word at a time. Returns false if they are the same.
+
+static bool sdl2_diff_span(const uint8_t *a, const uint8_t *b, size_t len, size_t *first, size_t *last) {
+    size_t i = 0;
+    size_t j = len;
+    size_t wa, wb;
+
+    while (i + sizeof(size_t) <= len) {
+        memcpy(&wa, a + i, sizeof(size_t));
+        memcpy(&wb, b + i, sizeof(size_t));
+        if (wa != wb) {
+            break;
+        }
+        i += sizeof(size_t);
+    }
+    while (i < len && a[i] == b[i]) {
+        i++;
+    }
+    if (i == len) {
+        return false;
+    }
+
+    while (j - i > sizeof(size_t)) {
+        memcpy(&wa, a + j - sizeof(size_t), sizeof(size_t));
+        memcpy(&wb, b + j - sizeof(size_t), sizeof(size_t));
+        if (wa != wb) {
+            break;
+        }
+        j -= sizeof(size_t);
+    }
+    while (a[j - 1] == b[j - 1]) {
+        j--;
+    }
+
+    *first = i;
+    *last = j - 1;
+    return true;
+}
+
+// Compare the buffer with the shadow copy of the last one shown and upload
+// the changed areas. Rows of the buffer are compared one at a time (a page of
+// 8 rows for MONO_VLSB), consecutive changed rows are merged into a rectangle
+// spanning the changed columns and the shadow copy is updated as it goes.
+// Called without the GIL like sdl2_upload().
+
+static const char *sdl2_upload_dirty(sdl2_obj_t *self, const uint8_t *buffer) {
+    size_t size = sdl2_buffer_size(self);
+    int rows_per_line = self->format == FRAMEBUF_MVLSB ? 8 : 1;
+    size_t line_len = self->format == FRAMEBUF_MVLSB ? (size_t)self->width : size / self->height;
+    size_t lines = size / line_len;
+
+    // bits of the buffer line per pixel column
+    int bits;
+    switch (self->format) {
+        case FRAMEBUF_RGB565:
+            bits = 16;
+            break;
+        case FRAMEBUF_GS4_HMSB:
+            bits = 4;
+            break;
+        case FRAMEBUF_GS2_HMSB:
+            bits = 2;
+            break;
+        case FRAMEBUF_MHLSB:
+        case FRAMEBUF_MHMSB:
+            bits = 1;
+            break;
+        default:
+            bits = 8;
+            break;
+    }
+
+    SDL_Rect dirty = {0, 0, 0, 0};
+    int x0 = 0;
+    int x1 = 0;
+
+    for (size_t line = 0; line <= lines; line++) {
+        size_t first, last;
+        size_t offset = line * line_len;
+
+        if (line < lines && sdl2_diff_span(self->shadow + offset, buffer + offset, line_len, &first, &last)) {
+            int y = line * rows_per_line;
+            int first_x = first * 8 / bits;
+            int last_x = ((last + 1) * 8 + bits - 1) / bits;
+            last_x = last_x > self->width ? self->width : last_x;
+
+            if (dirty.h == 0) {
+                dirty.y = y;
+                x0 = first_x;
+                x1 = last_x;
+            } else {
+                x0 = first_x < x0 ? first_x : x0;
+                x1 = last_x > x1 ? last_x : x1;
+            }
+            dirty.h = (y + rows_per_line > self->height ? self->height : y + rows_per_line) - dirty.y;
+            memcpy(self->shadow + offset + first, buffer + offset + first, last - first + 1);
+        } else if (dirty.h) {
+            dirty.x = x0;
+            dirty.w = x1 - x0;
+            const char *failed = sdl2_upload(self, buffer, &dirty);
+            if (failed) {
+                return failed;
+            }
+            dirty.h = 0;
+        }
+    }
+    return NULL;
+}
+
+// Read the next replay_events() entry, closing the file at the end
+static void sdl2_replay_read(sdl2_obj_t *self) {
+    if (fread(&self->replay_next, sizeof(self->replay_next), 1, self->replay_file) != 1) {
+        fclose(self->replay_file);
+        self->replay_file = NULL;
+    }
+}
+
+// Push the replayed events that were recorded before this frame was shown
+static void sdl2_replay_due(sdl2_obj_t *self) {
+    while (self->replay_file && self->replay_next.frame <= self->frames - self->replay_start) {
+        SDL_PushEvent(&self->replay_next.event);
+        sdl2_replay_read(self);
+    }
+}
+
+/// ### show
+///
+/// ```python
+/// SDL2.show(buffer=None, rect=None)
+/// ```
+/// #### Description
+///
+/// Show the buffer on the SDL2 window. When `rect` is given only the pixels
+/// inside it are converted and uploaded, the rest of the window keeps the
+/// contents of the previous show(). Without a `rect`, SDL2 objects created
+/// with `auto_dirty=True` upload only the areas that changed since the
+/// previous show().
+///
+/// #### Parameters
+///
+/// - `buffer` bytearray of pixels in the format given when the SDL2 object
+///    was created, or None to show the SDL2 object's own buffer. The SDL2
+///    object supports the buffer protocol so it can be used as the buffer of
+///    a framebuf.FrameBuffer, avoiding a bytearray on the MicroPython heap.
+/// - `rect` None to update the whole display, a (x, y, w, h) tuple or a list
+///    of (x, y, w, h) tuples of the areas of the buffer that have changed.
+///
+/// On ports with threads, other threads run while the buffer is converted and
+/// presented. The buffer must not be resized until show() returns.
+///
+/// #### Raises
+///
+/// - ValueError if the buffer is the wrong size.
+/// - RuntimeError for any SDL2 errors.
+
+static mp_obj_t sdl2_show(size_t n_args, const mp_obj_t *args) {
+	sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+	mp_buffer_info_t bufinfo;
+
+    if (n_args < 2 || args[1] == mp_const_none) {
+        sdl2_get_buffer(args[0], &bufinfo, MP_BUFFER_READ);
+    } else {
+        mp_get_buffer(args[1], &bufinfo, MP_BUFFER_READ);
+    }
+
+    // Check that there is a buffer.
+    if (bufinfo.buf == NULL) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("no buffer"));
+    }
+
+    // Check the buffer size.
+    if (bufinfo.len != sdl2_buffer_size(self)) {
+        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("buffer size mismatch"));
+    }
+
+    // Only one thread at a time may use the texture and staging buffer.
+    sdl2_check_idle(self);
+
+    // count the frame for replay_events() once the buffer is known to be valid
+    self->frames++;
+    sdl2_replay_due(self);
+
+    // Nothing is drawn while the window can't be seen. The texture misses the
+    // frames skipped, so the next frame shown is uploaded in full.
+    if (self->auto_pause && (SDL_GetWindowFlags(self->win) & (SDL_WINDOW_HIDDEN | SDL_WINDOW_MINIMIZED))) {
+        self->stale = true;
+        self->shadow_valid = false;
+        self->uploaded = 0;
+        return mp_const_none;
+    }
+
+    self->busy = true;
+
+    // The render thread may not upload while the staging buffer is being
+    // updated. The mutex is only ever waited for without the GIL.
+    if (self->render_thread) {
+        MP_THREAD_GIL_EXIT();
+        SDL_LockMutex(self->lock);
+        MP_THREAD_GIL_ENTER();
+    }
+
+    // release the mutex and busy flag if parsing a rect or SDL raises
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) != 0) {
+        if (self->render_thread) {
+            SDL_UnlockMutex(self->lock);
+        }
+        self->busy = false;
+        nlr_jump(nlr.ret_val);
+    }
+
+    const uint8_t *buffer = bufinfo.buf;
+    SDL_Rect rect = {0, 0, self->width, self->height};
+    const char *failed = NULL;
+    self->uploaded = 0;
+
+    // Conversion and upload run without the GIL, the buffer is kept alive by
+    // the caller's reference and must not be resized by another thread.
+    if (n_args < 3 || args[2] == mp_const_none || self->stale) {
+        MP_THREAD_GIL_EXIT();
+        if (self->auto_dirty && self->shadow_valid) {
+            failed = sdl2_upload_dirty(self, buffer);
+        } else {
+            failed = sdl2_upload(self, buffer, &rect);
+        }
+        MP_THREAD_GIL_ENTER();
+        sdl2_check(failed);
+        self->stale = false;
+
+        // after a full upload the texture matches the whole buffer
+        if (self->auto_dirty && !self->shadow_valid) {
+            memcpy(self->shadow, buffer, bufinfo.len);
+            self->shadow_valid = true;
+        }
+    } else {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_get_array(args[2], &len, &items);
+
+        // areas outside the rects may differ from the texture, the next
+        // show() without a rect uploads the whole buffer
+        self->shadow_valid = false;
+
+        if (len == 4 && mp_obj_is_int(items[0])) {
+            // a single (x, y, w, h) rectangle
+            if (sdl2_get_rect(self, args[2], &rect)) {
+                MP_THREAD_GIL_EXIT();
+                failed = sdl2_upload(self, buffer, &rect);
+                MP_THREAD_GIL_ENTER();
+                sdl2_check(failed);
+            }
+        } else {
+            for (size_t i = 0; i < len; i++) {
+                if (sdl2_get_rect(self, items[i], &rect)) {
+                    MP_THREAD_GIL_EXIT();
+                    failed = sdl2_upload(self, buffer, &rect);
+                    MP_THREAD_GIL_ENTER();
+                    sdl2_check(failed);
+                }
+            }
+        }
+    }
+
+    if (self->render_thread) {
+        self->frame_ready = true;
+        SDL_CondBroadcast(self->cond);
+        SDL_UnlockMutex(self->lock);
+    } else {
+        // the vsync wait in SDL_RenderPresent can take a whole refresh interval
+        MP_THREAD_GIL_EXIT();
+        if (SDL_RenderCopy(self->renderer, self->texture, NULL, NULL) != 0) {
+            failed = "SDL_RenderCopy";
+        } else {
+            SDL_RenderPresent(self->renderer);
+            self->presented = true;
+            self->present_time = sdl2_ticks_us();
+        }
+        MP_THREAD_GIL_ENTER();
+    }
+
+    nlr_pop();
+    self->busy = false;
+    sdl2_check(failed);
+	return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_show_obj, 1, 3, sdl2_show);
+
+/// ### uploaded_bytes()
+///
+/// ```python
+/// SDL2.uploaded_bytes()
+/// ```
+/// #### Description
+///
+/// Returns the number of bytes uploaded to the texture by the last show().
+///
+
+static mp_obj_t sdl2_uploaded_bytes(mp_obj_t self_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    return mp_obj_new_int_from_uint(self->uploaded);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_uploaded_bytes_obj, sdl2_uploaded_bytes);
+
+/// ### last_present_time()
+///
+/// ```python
+/// SDL2.last_present_time()
+/// ```
+/// #### Description
+///
+/// Returns when the last frame was presented as a time.ticks_us() value, for
+/// comparing with the DEQUEUE_TIME of events using time.ticks_diff().
+///
+/// #### Returns
+/// - time.ticks_us() value or None if no frame has been presented yet.
+
+static mp_obj_t sdl2_last_present_time(mp_obj_t self_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    bool presented;
+    mp_uint_t present_time;
+
+    if (self->render_thread) {
+        MP_THREAD_GIL_EXIT();
+        SDL_LockMutex(self->lock);
+        presented = self->presented;
+        present_time = self->present_time;
+        SDL_UnlockMutex(self->lock);
+        MP_THREAD_GIL_ENTER();
+    } else {
+        presented = self->presented;
+        present_time = self->present_time;
+    }
+    return presented ? mp_obj_new_int_from_uint(present_time) : mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_last_present_time_obj, sdl2_last_present_time);
+
+/// ### wait_idle()
+///
+/// ```python
+/// SDL2.wait_idle(timeout=-1)
+/// ```
+/// #### Description
+///
+/// Wait for the render thread of a threaded SDL2 object to present the last
+/// frame shown. Returns immediately for SDL2 objects that are not threaded.
+///
+/// #### Parameters
+/// - `timeout` maximum time to wait in milliseconds, -1 to wait forever, 0 to
+///    check without waiting.
+///
+/// #### Returns
+/// - True if the render thread is idle, False if the timeout expired first.
+
+static mp_obj_t sdl2_wait_idle(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t timeout = n_args > 1 ? mp_obj_get_int(args[1]) : -1;
+    bool idle = true;
+
+    if (self->render_thread) {
+        Uint32 start = SDL_GetTicks();
+
+        MP_THREAD_GIL_EXIT();
+        SDL_LockMutex(self->lock);
+        while (self->frame_ready || self->presenting) {
+            if (timeout < 0) {
+                SDL_CondWait(self->cond, self->lock);
+                continue;
+            }
+            Uint32 elapsed = SDL_GetTicks() - start;
+            if (elapsed >= (Uint32)timeout) {
+                idle = false;
+                break;
+            }
+            SDL_CondWaitTimeout(self->cond, self->lock, timeout - elapsed);
+        }
+        SDL_UnlockMutex(self->lock);
+        MP_THREAD_GIL_ENTER();
+    }
+    return mp_obj_new_bool(idle);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_wait_idle_obj, 1, 2, sdl2_wait_idle);
+
+// Present the texture again without uploading, for windows that were exposed.
+static void sdl2_present_again(sdl2_obj_t *self) {
+    if (self->render_thread) {
+        // a frame with nothing pending only presents
+        MP_THREAD_GIL_EXIT();
+        SDL_LockMutex(self->lock);
+        self->frame_ready = true;
+        SDL_CondBroadcast(self->cond);
+        SDL_UnlockMutex(self->lock);
+        MP_THREAD_GIL_ENTER();
+    } else if (self->renderer && !self->busy) {
+        SDL_RenderCopy(self->renderer, self->texture, NULL, NULL);
+        SDL_RenderPresent(self->renderer);
+    }
+}
+
+// Close the record_events() file, returns false if the data was not all written
+static bool sdl2_record_close(sdl2_obj_t *self) {
+    bool ok = !self->record_failed;
+
+    self->record_failed = false;
+    if (self->record_file) {
+        ok = !ferror(self->record_file) && ok;
+        ok = fclose(self->record_file) == 0 && ok;
+        self->record_file = NULL;
+    }
+    return ok;
+}
+
+// Act on events taken from the queue before they are returned
+static void sdl2_handle_event(sdl2_obj_t *self, const SDL_Event *event) {
+    // drop events hold pointers that would not be valid when replayed
+    if (self->record_file && event->type != SDL_DROPFILE && event->type != SDL_DROPTEXT) {
+        sdl2_event_entry_t entry;
+        memset(&entry, 0, sizeof(entry));
+        entry.frame = self->frames - self->record_start;
+        entry.event = *event;
+        // The event has left the queue and must still be delivered, so the
+        // failure is reported by the next record_events() call.
+        if (fwrite(&entry, sizeof(entry), 1, self->record_file) != 1) {
+            sdl2_record_close(self);
+            self->record_failed = true;
+        }
+    }
+
+    if (self->auto_pause
+        && event->type == SDL_WINDOWEVENT
+        && event->window.event == SDL_WINDOWEVENT_EXPOSED
+        && event->window.windowID == SDL_GetWindowID(self->win)) {
+        sdl2_present_again(self);
+    }
+}
+
+/// ### event
+///
+/// ```python
+/// SDL2.event()
+/// ```
+///
+/// #### Description
+///
+/// Checks for events and returns a tuple describing the event if there is one,
+/// otherwise returns None.
+///
+/// #### Returns:
+///
+/// - None or a tuple describing the event
+///
+/// The last two items of every event tuple are timestamps:
+///
+/// Index            | Item         | Description
+/// -----------------|--------------|------------
+/// sdl.TIMESTAMP    | timestamp    | milliseconds since SDL was initialized when SDL queued the event
+/// sdl.DEQUEUE_TIME | dequeue_time | time.ticks_us() value when the event was taken from the queue
+///
+/// #### Event Types:
+
+// Make an event tuple from the first n items and append the timestamps
+static mp_obj_t sdl2_event_tuple(const SDL_Event *event, size_t n, const mp_obj_t *items) {
+    mp_obj_tuple_t *tuple = MP_OBJ_TO_PTR(mp_obj_new_tuple(n + 2, NULL));
+
+    memcpy(tuple->items, items, n * sizeof(mp_obj_t));
+    tuple->items[n] = mp_obj_new_int_from_uint(event->common.timestamp);
+    tuple->items[n + 1] = mp_obj_new_int_from_uint(sdl2_ticks_us());
+    return MP_OBJ_FROM_PTR(tuple);
+}
+
+// Fill in the precise scroll amounts and mouse position of a wheel event,
+// which older versions of SDL do not include in the event.
+static void sdl2_wheel_payload(sdl2_obj_t *self, const SDL_MouseWheelEvent *wheel, float *precise_x, float *precise_y, int *mouse_x, int *mouse_y) {
+    #if SDL_VERSION_ATLEAST(2, 0, 18)
+    *precise_x = wheel->preciseX;
+    *precise_y = wheel->preciseY;
+    #else
+    *precise_x = wheel->x;
+    *precise_y = wheel->y;
+    #endif
+
+    #if SDL_VERSION_ATLEAST(2, 26, 0)
+    *mouse_x = wheel->mouseX;
+    *mouse_y = wheel->mouseY;
+    #else
+    SDL_GetMouseState(mouse_x, mouse_y);
+    #endif
+
+    *mouse_x /= self->x_scale;
+    *mouse_y /= self->y_scale;
+}
+
+// Convert an event to the tuple returned by poll_event(), the tuple layouts
+// are documented below.
+
+static mp_obj_t sdl2_event_obj(sdl2_obj_t *self, const SDL_Event *event) {
+	switch(event->type) {
+		case SDL_WINDOWEVENT:
+
+            ///   - SDL_WINDOWEVENT
+            ///
+            ///     (event_type, window_event, data1, data2)
+            ///
+            ///     | Index            | Item         | Description
+            ///     |------------------|--------------|------------
+            ///     | sdl.EVENT        | event_type   | SDL_WINDOWEVENT
+            ///     | sdl.WINDOW_EVENT | window_event | SDL_WINDOWEVENT_* describing what happened to the window
+            ///     | sdl.DATA1        | data1        | new width in window pixels for SDL_WINDOWEVENT_RESIZED, x position for SDL_WINDOWEVENT_MOVED
+            ///     | sdl.DATA2        | data2        | new height in window pixels for SDL_WINDOWEVENT_RESIZED, y position for SDL_WINDOWEVENT_MOVED
+
+			{
+				mp_obj_t window[4] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->window.event),
+					mp_obj_new_int(event->window.data1),
+					mp_obj_new_int(event->window.data2)
+				};
+				return sdl2_event_tuple(event, 4, window);
+			}
+
+		case SDL_KEYDOWN:
+		case SDL_KEYUP:
+
+            ///   - SDL_KEYDOWN or SDL_KEYUP
+            ///
+            ///     (event_type, keyname, mod)
+            ///
+            ///     Index       | Item       | Description
+            ///     ------------|------------|------------
+            ///     sdl.EVENT   | event_type | SDL_KEYDOWN or SDL_KEYUP
+            ///     sdl.KEYNAME | keyname    | name of the key pressed or released if any
+            ///     sdl.MOD     | mod        | status of modifier keys (shift, ctrl, alt, etc.)
+            ///
+            ///     Key names are interned, the same key always returns the
+            ///     same str object. When the SDL2 object was created with
+            ///     keycodes=True the tuple holds integers instead:
+            ///
+            ///     (event_type, keycode, mod, scancode)
+            ///
+            ///     Index        | Item       | Description
+            ///     -------------|------------|------------
+            ///     sdl.EVENT    | event_type | SDL_KEYDOWN or SDL_KEYUP
+            ///     sdl.KEYCODE  | keycode    | SDLK_* keycode of the key
+            ///     sdl.MOD      | mod        | status of modifier keys (shift, ctrl, alt, etc.)
+            ///     sdl.SCANCODE | scancode   | SDL_SCANCODE_* physical key
+
+			if (self->keycodes) {
+				mp_obj_t result[4] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->key.keysym.sym),
+					mp_obj_new_int(event->key.keysym.mod),
+					mp_obj_new_int(event->key.keysym.scancode)
+				};
+				return sdl2_event_tuple(event, 4, result);
+			} else {
+				// a qstr is only added to the pool the first time a key is seen
+				mp_obj_t result[3] = {
+					mp_obj_new_int(event->type),
+					MP_OBJ_NEW_QSTR(qstr_from_str(SDL_GetKeyName(event->key.keysym.sym))),
+					mp_obj_new_int(event->key.keysym.mod)
+				};
+				return sdl2_event_tuple(event, 3, result);
+			}
+
+		case SDL_TEXTINPUT:
+
+            ///   - SDL_TEXTINPUT
+            ///
+            ///     (event_type, text)
+            ///
+            ///     | Index     | Item       | Description
+            ///     |-----------|------------|------------
+            ///     | sdl.EVENT | event_type | SDL_TEXTINPUT
+            ///     | sdl.TEXT  | text       | str of the characters typed, using the keyboard layout and input method
+
+			{
+				mp_obj_t text_input[2] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_str(event->text.text, strlen(event->text.text))
+				};
+				return sdl2_event_tuple(event, 2, text_input);
+			}
+
+		case SDL_TEXTEDITING:
+
+            ///   - SDL_TEXTEDITING
+            ///
+            ///     (event_type, text, start, length)
+            ///
+            ///     | Index      | Item       | Description
+            ///     |------------|------------|------------
+            ///     | sdl.EVENT  | event_type | SDL_TEXTEDITING
+            ///     | sdl.TEXT   | text       | str of the text being composed by the input method
+            ///     | sdl.START  | start      | position of the cursor in the text
+            ///     | sdl.LENGTH | length     | number of characters selected
+
+			{
+				mp_obj_t text_editing[4] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_str(event->edit.text, strlen(event->edit.text)),
+					mp_obj_new_int(event->edit.start),
+					mp_obj_new_int(event->edit.length)
+				};
+				return sdl2_event_tuple(event, 4, text_editing);
+			}
+
+		case SDL_MOUSEMOTION:
+
+            ///   - SDL_MOUSEMOTION
+            ///
+            ///     (event_type, x, y, xrel, yrel, state)
+            ///
+            ///      Index       | Item       | Description
+            ///     -------------|------------|------------
+            ///      sdl.EVENT   | event_type | SDL_MOUSEMOTION
+            ///      sdl.X       | x          | coordinates of the mouse
+            ///      sdl.Y       | y          | coordinates of the mouse
+            ///      sdl.XREL    | xrel       | relative motion in the X direction
+            ///      sdl.YREL    | yrel       | relative motion in the Y direction
+            ///      sdl.STATE   | state      | state of the mouse buttons
+			{
+				mp_obj_t mouse_motion[6] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->motion.x / self->x_scale),
+					mp_obj_new_int(event->motion.y / self->y_scale),
+					mp_obj_new_int(event->motion.xrel / self->x_scale),
+					mp_obj_new_int(event->motion.yrel / self->y_scale),
+					mp_obj_new_int(event->motion.state)
+				};
+				return sdl2_event_tuple(event, 6, mouse_motion);
+			}
+
+		case SDL_MOUSEBUTTONDOWN:
+		case SDL_MOUSEBUTTONUP:
+
+            ///   - SDL_MOUSEBUTTONDOWN or SDL_MOUSEBUTTONUP
+            ///
+            ///     (event_type, x, y, button)
+            ///
+            ///     | Index       | Item       | Description
+            ///     |-------------|------------|------------
+            ///     | sdl.EVENT   | event_type | SDL_MOUSEBUTTONDOWN or SDL_MOUSEBUTTONUP
+            ///     | sdl.X       | x          | coordinates of the mouse
+            ///     | sdl.Y       | y          | coordinates of the mouse
+            ///     | sdl.BUTTON  | button     | button pressed or released
+			{
+				mp_obj_t mouse_button[4] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->button.x / self->x_scale),
+					mp_obj_new_int(event->button.y / self->y_scale),
+					mp_obj_new_int(event->button.button)
+				};
+				return sdl2_event_tuple(event, 4, mouse_button);
+			}
+
+		case SDL_MOUSEWHEEL:
+
+            ///   - SDL_MOUSEWHEEL
+            ///
+            ///     (event_type, x, y, direction, preciseX, preciseY, mouseX, mouseY)
+            ///
+            ///     | Index         | Item       | Description
+            ///     |---------------|------------|------------
+            ///     | sdl.EVENT     | event_type | SDL_MOUSEWHEEL
+            ///     | sdl.X         | x          | amount scrolled horizontally
+            ///     | sdl.Y         | y          | amount scrolled vertically
+            ///     | sdl.DIRECTION | direction  | direction of the scroll
+            ///     | sdl.PRECISEX  | preciseX   | amount scrolled horizontally, positive to the right and negative to the left, with float precision
+            ///     | sdl.PRECISEY  | preciseY   | amount scrolled vertically, positive away from the user and negative toward the user, with float precision
+            ///     | sdl.MOUSEX    | mouseX     | X coordinate of the mouse in virtual pixels
+            ///     | sdl.MOUSEY    | mouseY     | Y coordinate of the mouse in virtual pixels
+
+			{
+				float precise_x, precise_y;
+				int mouse_x, mouse_y;
+				sdl2_wheel_payload(self, &event->wheel, &precise_x, &precise_y, &mouse_x, &mouse_y);
+
+				mp_obj_t mouse_wheel[8] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->wheel.x),
+					mp_obj_new_int(event->wheel.y),
+					mp_obj_new_int(event->wheel.direction),
+					mp_obj_new_float(precise_x),
+					mp_obj_new_float(precise_y),
+					mp_obj_new_int(mouse_x),
+					mp_obj_new_int(mouse_y)
+				};
+				return sdl2_event_tuple(event, 8, mouse_wheel);
+			}
+
+		case SDL_CONTROLLERAXISMOTION:
+
+            ///   - SDL_CONTROLLERAXISMOTION
+            ///
+            ///     (event_type, which, axis, value)
+            ///
+            ///     | Index     | Item       | Description
+            ///     |-----------|------------|------------
+            ///     | sdl.EVENT | event_type | SDL_CONTROLLERAXISMOTION
+            ///     | sdl.WHICH | which      | instance id of the controller
+            ///     | sdl.AXIS  | axis       | SDL_CONTROLLER_AXIS_* axis that moved
+            ///     | sdl.VALUE | value      | new position of the axis, -32768 to 32767
+
+			{
+				mp_obj_t controller_axis[4] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->caxis.which),
+					mp_obj_new_int(event->caxis.axis),
+					mp_obj_new_int(event->caxis.value)
+				};
+				return sdl2_event_tuple(event, 4, controller_axis);
+			}
+
+		case SDL_CONTROLLERBUTTONDOWN:
+		case SDL_CONTROLLERBUTTONUP:
+
+            ///   - SDL_CONTROLLERBUTTONDOWN or SDL_CONTROLLERBUTTONUP
+            ///
+            ///     (event_type, which, button, state)
+            ///
+            ///     | Index                 | Item       | Description
+            ///     |-----------------------|------------|------------
+            ///     | sdl.EVENT             | event_type | SDL_CONTROLLERBUTTONDOWN or SDL_CONTROLLERBUTTONUP
+            ///     | sdl.WHICH             | which      | instance id of the controller
+            ///     | sdl.CONTROLLER_BUTTON | button     | SDL_CONTROLLER_BUTTON_* button pressed or released
+            ///     | sdl.BUTTON_STATE      | state      | 1 if pressed, 0 if released
+
+			{
+				mp_obj_t controller_button[4] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->cbutton.which),
+					mp_obj_new_int(event->cbutton.button),
+					mp_obj_new_int(event->cbutton.state)
+				};
+				return sdl2_event_tuple(event, 4, controller_button);
+			}
+
+		case SDL_CONTROLLERDEVICEADDED:
+		case SDL_CONTROLLERDEVICEREMOVED:
+		case SDL_CONTROLLERDEVICEREMAPPED:
+
+            ///   - SDL_CONTROLLERDEVICEADDED, SDL_CONTROLLERDEVICEREMOVED or SDL_CONTROLLERDEVICEREMAPPED
+            ///
+            ///     (event_type, which)
+            ///
+            ///     | Index     | Item       | Description
+            ///     |-----------|------------|------------
+            ///     | sdl.EVENT | event_type | SDL_CONTROLLERDEVICEADDED, SDL_CONTROLLERDEVICEREMOVED or SDL_CONTROLLERDEVICEREMAPPED
+            ///     | sdl.WHICH | which      | device index to pass to open_controller() for SDL_CONTROLLERDEVICEADDED, otherwise the instance id
+
+			{
+				mp_obj_t controller_device[2] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int(event->cdevice.which)
+				};
+				return sdl2_event_tuple(event, 2, controller_device);
+			}
+
+		case SDL_FINGERDOWN:
+		case SDL_FINGERUP:
+		case SDL_FINGERMOTION:
+
+            ///   - SDL_FINGERDOWN, SDL_FINGERUP or SDL_FINGERMOTION
+            ///
+            ///     (event_type, x, y, dx, dy, pressure, finger_id)
+            ///
+            ///     | Index         | Item       | Description
+            ///     |---------------|------------|------------
+            ///     | sdl.EVENT     | event_type | SDL_FINGERDOWN, SDL_FINGERUP or SDL_FINGERMOTION
+            ///     | sdl.X         | x          | coordinates of the touch in virtual pixels
+            ///     | sdl.Y         | y          | coordinates of the touch in virtual pixels
+            ///     | sdl.XREL      | dx         | distance moved in the X direction in virtual pixels
+            ///     | sdl.YREL      | dy         | distance moved in the Y direction in virtual pixels
+            ///     | sdl.PRESSURE  | pressure   | pressure of the touch, 0.0 to 1.0
+            ///     | sdl.FINGER_ID | finger_id  | id of the finger, the same from SDL_FINGERDOWN to SDL_FINGERUP
+
+			{
+				mp_obj_t finger[7] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int((mp_int_t)(event->tfinger.x * self->width)),
+					mp_obj_new_int((mp_int_t)(event->tfinger.y * self->height)),
+					mp_obj_new_int((mp_int_t)(event->tfinger.dx * self->width)),
+					mp_obj_new_int((mp_int_t)(event->tfinger.dy * self->height)),
+					mp_obj_new_float(event->tfinger.pressure),
+					mp_obj_new_int_from_ll(event->tfinger.fingerId)
+				};
+				return sdl2_event_tuple(event, 7, finger);
+			}
+
+		case SDL_MULTIGESTURE:
+
+            ///   - SDL_MULTIGESTURE
+            ///
+            ///     (event_type, x, y, d_theta, d_dist, num_fingers)
+            ///
+            ///     | Index           | Item        | Description
+            ///     |-----------------|-------------|------------
+            ///     | sdl.EVENT       | event_type  | SDL_MULTIGESTURE
+            ///     | sdl.X           | x           | center of the gesture in virtual pixels
+            ///     | sdl.Y           | y           | center of the gesture in virtual pixels
+            ///     | sdl.D_THETA     | d_theta     | rotation of the fingers in radians
+            ///     | sdl.D_DIST      | d_dist      | change in the distance between the fingers, relative to the window size
+            ///     | sdl.NUM_FINGERS | num_fingers | number of fingers touching
+
+			{
+				mp_obj_t gesture[6] = {
+					mp_obj_new_int(event->type),
+					mp_obj_new_int((mp_int_t)(event->mgesture.x * self->width)),
+					mp_obj_new_int((mp_int_t)(event->mgesture.y * self->height)),
+					mp_obj_new_float(event->mgesture.dTheta),
+					mp_obj_new_float(event->mgesture.dDist),
+					mp_obj_new_int(event->mgesture.numFingers)
+				};
+				return sdl2_event_tuple(event, 6, gesture);
+			}
+	}
+
+    ///   - SDL_QUIT
+    ///
+    ///     | Index         | Item       | Description
+    ///     |---------------|------------|------------
+    ///     | sdl.EVENT     | event_type | SDL_QUIT
+    ///
+    ///   - all others return a tuple containing the integer (event_type) id of the event
+    ///
+    ///     | Index         | Item       | Description
+    ///     |---------------|------------|------------
+    ///     | sdl.EVENT     | event_type | integer event_type id
+
+	mp_obj_t event_type[1] = {
+		mp_obj_new_int(event->type)
+	};
+
+	return sdl2_event_tuple(event, 1, event_type);
+}
+
+static mp_obj_t sdl2_poll_event(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+  	SDL_Event event;
+
+	if (SDL_PollEvent(&event)) {
+        sdl2_handle_event(self, &event);
+        return sdl2_event_obj(self, &event);
+	}
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_poll_event_obj, 1, 1, sdl2_poll_event);
+
+/// ### wait_event()
+///
+/// ```python
+/// SDL2.wait_event(timeout=-1)
+/// ```
+///
+/// #### Description
+///
+/// Sleeps until an event arrives or the timeout expires instead of spinning
+/// on poll_event(). Pending callbacks and KeyboardInterrupt are still
+/// handled while waiting.
+///
+/// #### Parameters
+///
+/// - `timeout` maximum time to wait in milliseconds, -1 to wait forever.
+///
+/// #### Returns:
+///
+/// - None if the timeout expired or a tuple describing the event in the same
+///   format as poll_event()
+
+// longest time wait_event() sleeps in SDL before checking for pending events
+#define SDL2_WAIT_SLICE_MS (20)
+
+static mp_obj_t sdl2_wait_event(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t timeout = n_args > 1 ? mp_obj_get_int(args[1]) : -1;
+    Uint32 start = SDL_GetTicks();
+    SDL_Event event;
+
+    for (;;) {
+        int slice = SDL2_WAIT_SLICE_MS;
+        if (timeout >= 0) {
+            Uint32 elapsed = SDL_GetTicks() - start;
+            if (elapsed >= (Uint32)timeout) {
+                slice = 0;
+            } else if (timeout - elapsed < (Uint32)slice) {
+                slice = timeout - elapsed;
+            }
+        }
+
+        MP_THREAD_GIL_EXIT();
+        int got = slice ? SDL_WaitEventTimeout(&event, slice) : SDL_PollEvent(&event);
+        MP_THREAD_GIL_ENTER();
+
+        if (got) {
+            sdl2_handle_event(self, &event);
+            return sdl2_event_obj(self, &event);
+        }
+        if (slice == 0) {
+            return mp_const_none;
+        }
+        mp_handle_pending(true);
+    }
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_wait_event_obj, 1, 2, sdl2_wait_event);
+
+/// ### poll_events()
+///
+/// ```python
+/// SDL2.poll_events(max=64, coalesce=False)
+/// ```
+///
+/// #### Description
+///
+/// Removes up to `max` pending events from the queue in one call and returns
+/// a list of tuples in the same format as poll_event(), empty if there are no
+/// events.
+///
+/// #### Parameters
+///
+/// - `max` maximum number of events to remove from the queue. Default: 64
+/// - `coalesce` merge consecutive SDL_MOUSEMOTION events into one with the
+///    last position and state and the summed relative motion. Default: False
+///
+/// #### Returns:
+///
+/// - list of event tuples
+
+// events taken from the SDL queue per SDL_PeepEvents call
+#define SDL2_PEEP_EVENTS (16)
+
+static mp_obj_t sdl2_poll_events(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_self, ARG_max, ARG_coalesce };
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+        {MP_QSTR_max, MP_ARG_INT, {.u_int = 64}},
+        {MP_QSTR_coalesce, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false}},
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
+    mp_int_t remaining = args[ARG_max].u_int;
+    bool coalesce = args[ARG_coalesce].u_bool;
+
+    mp_obj_t list = mp_obj_new_list(0, NULL);
+    SDL_Event events[SDL2_PEEP_EVENTS];
+    SDL_Event motion;
+    bool have_motion = false;
+
+    SDL_PumpEvents();
+    while (remaining > 0) {
+        int count = SDL_PeepEvents(events, remaining < SDL2_PEEP_EVENTS ? remaining : SDL2_PEEP_EVENTS, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+        if (count <= 0) {
+            break;
+        }
+        remaining -= count;
+
+        for (int i = 0; i < count; i++) {
+            SDL_Event *event = &events[i];
+            sdl2_handle_event(self, event);
+
+            if (coalesce && event->type == SDL_MOUSEMOTION) {
+                if (have_motion) {
+                    event->motion.xrel += motion.motion.xrel;
+                    event->motion.yrel += motion.motion.yrel;
+                }
+                motion = *event;
+                have_motion = true;
+                continue;
+            }
+
+            if (have_motion) {
+                mp_obj_list_append(list, sdl2_event_obj(self, &motion));
+                have_motion = false;
+            }
+            mp_obj_list_append(list, sdl2_event_obj(self, event));
+        }
+    }
+
+    if (have_motion) {
+        mp_obj_list_append(list, sdl2_event_obj(self, &motion));
+    }
+    return list;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(sdl2_poll_events_obj, 1, sdl2_poll_events);
+
+/// ### poll_into()
+///
+/// ```python
+/// SDL2.poll_into(buffer)
+/// ```
+///
+/// #### Description
+///
+/// Removes pending events from the queue and writes them into `buffer` as
+/// fixed size records of RECORD_SIZE 32 bit integers without allocating any
+/// objects. Stops when the queue is empty or the buffer is full.
+///
+/// Items 0 to 7 of each record use the same index constants as the
+/// poll_event() tuples, unused items are zero. SDL_KEYDOWN and SDL_KEYUP
+/// records hold the integer keycode at KEYCODE and the scancode at SCANCODE
+/// instead of the key name. Float items are stored in thousandths: PRECISEX
+/// and PRECISEY of SDL_MOUSEWHEEL, PRESSURE of SDL_FINGER* and D_THETA and
+/// D_DIST of SDL_MULTIGESTURE. FINGER_ID holds the low 32 bits of the finger
+/// id. SDL_TEXTINPUT records hold up to 27 bytes of UTF-8 text, zero
+/// terminated, in the bytes of items 1 to 7. SDL_TEXTEDITING records hold
+/// START and LENGTH followed by up to 15 bytes of UTF-8 text, zero
+/// terminated, in the bytes of items 4 to 7. RECORD_TIMESTAMP holds the SDL
+/// timestamp of the event in milliseconds and RECORD_DEQUEUE_TIME the low 32
+/// bits of the time.ticks_us() value when the event was taken from the queue.
+///
+/// #### Parameters
+///
+/// - `buffer` writable buffer such as array('i') or bytearray
+///
+/// #### Returns:
+///
+/// - number of records written
+///
+/// #### Raises
+///
+/// - ValueError if the buffer is not 4 byte aligned.
+
+// 32 bit integers per poll_into() record
+#define SDL2_RECORD_SIZE (10)
+#define SDL2_RECORD_TIMESTAMP (8)
+#define SDL2_RECORD_DEQUEUE_TIME (9)
+
+// bytes of SDL_TEXTINPUT text that fit in items 1 to 7 of a record
+#define SDL2_RECORD_TEXT_SIZE (7 * sizeof(int32_t))
+
+// SDL_TEXTEDITING text is held in items 4 to 7, after START and LENGTH
+#define SDL2_RECORD_EDIT_TEXT (4)
+#define SDL2_RECORD_EDIT_TEXT_SIZE (4 * sizeof(int32_t))
+
+// Get a buffer of records, which are accessed as int32_t in place so must be
+// aligned. A memoryview sliced at an odd offset would not be.
+static void sdl2_get_records(mp_obj_t buffer_in, mp_buffer_info_t *bufinfo, mp_uint_t flags) {
+    mp_get_buffer_raise(buffer_in, bufinfo, flags);
+    if ((uintptr_t)bufinfo->buf & (sizeof(int32_t) - 1)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer not 4 byte aligned"));
+    }
+}
+
+static void sdl2_event_record(sdl2_obj_t *self, const SDL_Event *event, int32_t *record) {
+    memset(record, 0, SDL2_RECORD_SIZE * sizeof(int32_t));
+    record[0] = event->type;
+    record[SDL2_RECORD_TIMESTAMP] = event->common.timestamp;
+    record[SDL2_RECORD_DEQUEUE_TIME] = sdl2_ticks_us();
+
+    switch (event->type) {
+        case SDL_WINDOWEVENT:
+            record[1] = event->window.event;
+            record[2] = event->window.data1;
+            record[3] = event->window.data2;
+            break;
+
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            record[1] = event->key.keysym.sym;
+            record[2] = event->key.keysym.mod;
+            record[3] = event->key.keysym.scancode;
+            break;
+
+        case SDL_TEXTINPUT:
+            SDL_utf8strlcpy((char *)&record[1], event->text.text, SDL2_RECORD_TEXT_SIZE);
+            break;
+
+        case SDL_TEXTEDITING:
+            record[2] = event->edit.start;
+            record[3] = event->edit.length;
+            SDL_utf8strlcpy((char *)&record[SDL2_RECORD_EDIT_TEXT], event->edit.text, SDL2_RECORD_EDIT_TEXT_SIZE);
+            break;
+
+        case SDL_MOUSEMOTION:
+            record[1] = event->motion.x / self->x_scale;
+            record[2] = event->motion.y / self->y_scale;
+            record[3] = event->motion.xrel / self->x_scale;
+            record[4] = event->motion.yrel / self->y_scale;
+            record[5] = event->motion.state;
+            break;
+
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            record[1] = event->button.x / self->x_scale;
+            record[2] = event->button.y / self->y_scale;
+            record[3] = event->button.button;
+            break;
+
+        case SDL_MOUSEWHEEL:
+            {
+                float precise_x, precise_y;
+                int mouse_x, mouse_y;
+                sdl2_wheel_payload(self, &event->wheel, &precise_x, &precise_y, &mouse_x, &mouse_y);
+
+                record[1] = event->wheel.x;
+                record[2] = event->wheel.y;
+                record[3] = event->wheel.direction;
+                record[4] = lroundf(precise_x * 1000);
+                record[5] = lroundf(precise_y * 1000);
+                record[6] = mouse_x;
+                record[7] = mouse_y;
+            }
+            break;
+
+        case SDL_CONTROLLERAXISMOTION:
+            record[1] = event->caxis.which;
+            record[2] = event->caxis.axis;
+            record[3] = event->caxis.value;
+            break;
+
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+            record[1] = event->cbutton.which;
+            record[2] = event->cbutton.button;
+            record[3] = event->cbutton.state;
+            break;
+
+        case SDL_CONTROLLERDEVICEADDED:
+        case SDL_CONTROLLERDEVICEREMOVED:
+        case SDL_CONTROLLERDEVICEREMAPPED:
+            record[1] = event->cdevice.which;
+            break;
+
+        case SDL_FINGERDOWN:
+        case SDL_FINGERUP:
+        case SDL_FINGERMOTION:
+            record[1] = (int32_t)(event->tfinger.x * self->width);
+            record[2] = (int32_t)(event->tfinger.y * self->height);
+            record[3] = (int32_t)(event->tfinger.dx * self->width);
+            record[4] = (int32_t)(event->tfinger.dy * self->height);
+            record[5] = lroundf(event->tfinger.pressure * 1000);
+            record[6] = event->tfinger.fingerId;
+            break;
+
+        case SDL_MULTIGESTURE:
+            record[1] = (int32_t)(event->mgesture.x * self->width);
+            record[2] = (int32_t)(event->mgesture.y * self->height);
+            record[3] = lroundf(event->mgesture.dTheta * 1000);
+            record[4] = lroundf(event->mgesture.dDist * 1000);
+            record[5] = event->mgesture.numFingers;
+            break;
+    }
+}
+
+static mp_obj_t sdl2_poll_into(mp_obj_t self_in, mp_obj_t buffer_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    sdl2_get_records(buffer_in, &bufinfo, MP_BUFFER_WRITE);
+
+    int32_t *record = bufinfo.buf;
+    size_t count = 0;
+    size_t max = bufinfo.len / (SDL2_RECORD_SIZE * sizeof(int32_t));
+    SDL_Event event;
+
+    while (count < max && SDL_PollEvent(&event)) {
+        sdl2_handle_event(self, &event);
+        sdl2_event_record(self, &event, record);
+        record += SDL2_RECORD_SIZE;
+        count++;
+    }
+    return mp_obj_new_int(count);
+}
+static MP_DEFINE_CONST_FUN_OBJ_2(sdl2_poll_into_obj, sdl2_poll_into);
+
+// Build an event from a poll_into() record, the reverse of sdl2_event_record
+static void sdl2_record_event(sdl2_obj_t *self, const int32_t *record, SDL_Event *event) {
+    Uint32 window_id = SDL_GetWindowID(self->win);
+
+    memset(event, 0, sizeof(SDL_Event));
+    event->type = record[0];
+    event->common.timestamp = SDL_GetTicks();
+
+    switch (event->type) {
+        case SDL_WINDOWEVENT:
+            event->window.windowID = window_id;
+            event->window.event = record[1];
+            event->window.data1 = record[2];
+            event->window.data2 = record[3];
+            break;
+
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:
+            event->key.windowID = window_id;
+            event->key.state = event->type == SDL_KEYDOWN ? SDL_PRESSED : SDL_RELEASED;
+            event->key.keysym.sym = record[1];
+            event->key.keysym.mod = record[2];
+            event->key.keysym.scancode = record[3];
+            break;
+
+        case SDL_TEXTINPUT:
+            {
+                // the record text may not be zero terminated
+                char text[SDL2_RECORD_TEXT_SIZE + 1];
+                memcpy(text, &record[1], SDL2_RECORD_TEXT_SIZE);
+                text[SDL2_RECORD_TEXT_SIZE] = '\0';
+
+                event->text.windowID = window_id;
+                SDL_utf8strlcpy(event->text.text, text, sizeof(event->text.text));
+            }
+            break;
+
+        case SDL_TEXTEDITING:
+            {
+                char text[SDL2_RECORD_EDIT_TEXT_SIZE + 1];
+                memcpy(text, &record[SDL2_RECORD_EDIT_TEXT], SDL2_RECORD_EDIT_TEXT_SIZE);
+                text[SDL2_RECORD_EDIT_TEXT_SIZE] = '\0';
+
+                event->edit.windowID = window_id;
+                SDL_utf8strlcpy(event->edit.text, text, sizeof(event->edit.text));
+                event->edit.start = record[2];
+                event->edit.length = record[3];
+            }
+            break;
+
+        case SDL_MOUSEMOTION:
+            event->motion.windowID = window_id;
+            event->motion.x = record[1] * self->x_scale;
+            event->motion.y = record[2] * self->y_scale;
+            event->motion.xrel = record[3] * self->x_scale;
+            event->motion.yrel = record[4] * self->y_scale;
+            event->motion.state = record[5];
+            break;
+
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:
+            event->button.windowID = window_id;
+            event->button.state = event->type == SDL_MOUSEBUTTONDOWN ? SDL_PRESSED : SDL_RELEASED;
+            event->button.clicks = 1;
+            event->button.x = record[1] * self->x_scale;
+            event->button.y = record[2] * self->y_scale;
+            event->button.button = record[3];
+            break;
+
+        case SDL_MOUSEWHEEL:
+            event->wheel.windowID = window_id;
+            event->wheel.x = record[1];
+            event->wheel.y = record[2];
+            event->wheel.direction = record[3];
+            #if SDL_VERSION_ATLEAST(2, 0, 18)
+            event->wheel.preciseX = record[4] / 1000.0f;
+            event->wheel.preciseY = record[5] / 1000.0f;
+            #endif
+            #if SDL_VERSION_ATLEAST(2, 26, 0)
+            event->wheel.mouseX = record[6] * self->x_scale;
+            event->wheel.mouseY = record[7] * self->y_scale;
+            #endif
+            break;
+
+        case SDL_CONTROLLERAXISMOTION:
+            event->caxis.which = record[1];
+            event->caxis.axis = record[2];
+            event->caxis.value = record[3];
+            break;
+
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+            event->cbutton.which = record[1];
+            event->cbutton.button = record[2];
+            event->cbutton.state = record[3];
+            break;
+
+        case SDL_CONTROLLERDEVICEADDED:
+        case SDL_CONTROLLERDEVICEREMOVED:
+        case SDL_CONTROLLERDEVICEREMAPPED:
+            event->cdevice.which = record[1];
+            break;
+
+        case SDL_FINGERDOWN:
+        case SDL_FINGERUP:
+        case SDL_FINGERMOTION:
+            event->tfinger.x = (float)record[1] / self->width;
+            event->tfinger.y = (float)record[2] / self->height;
+            event->tfinger.dx = (float)record[3] / self->width;
+            event->tfinger.dy = (float)record[4] / self->height;
+            event->tfinger.pressure = record[5] / 1000.0f;
+            event->tfinger.fingerId = record[6];
+            break;
+
+        case SDL_MULTIGESTURE:
+            event->mgesture.x = (float)record[1] / self->width;
+            event->mgesture.y = (float)record[2] / self->height;
+            event->mgesture.dTheta = record[3] / 1000.0f;
+            event->mgesture.dDist = record[4] / 1000.0f;
+            event->mgesture.numFingers = record[5];
+            break;
+    }
+}
+
+/// ### push_event()
+///
+/// ```python
+/// SDL2.push_event(event_type, *items)
+/// ```
+///
+/// #### Description
+///
+/// Adds an event to the queue as if it came from an input device, for
+/// testing event handling without one. The items are integers in the same
+/// order and units as items 1 to 7 of a poll_into() record, coordinates are
+/// in virtual pixels. The text of a SDL_TEXTINPUT event may be given as a
+/// str, and a SDL_TEXTEDITING event may be given as text, start and length
+/// like its poll_event() tuple. Missing items are zero.
+///
+/// #### Parameters
+///
+/// - `event_type` type of the event, for example SDL_MOUSEBUTTONDOWN
+/// - `items` up to 7 event items, for example x, y, button
+///
+/// #### Returns:
+///
+/// - True if the event was queued, False if set_event_filter() ignores its
+///    type, or it is SDL_TEXTINPUT or SDL_TEXTEDITING after stop_text_input()
+///
+/// #### Raises
+///
+/// - RuntimeError for any SDL2 errors.
+
+static mp_obj_t sdl2_push_event(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    int32_t record[SDL2_RECORD_SIZE] = {0};
+    SDL_Event event;
+
+    record[0] = mp_obj_get_int(args[1]);
+    if (record[0] == SDL_TEXTINPUT && n_args == 3 && mp_obj_is_str(args[2])) {
+        SDL_utf8strlcpy((char *)&record[1], mp_obj_str_get_str(args[2]), SDL2_RECORD_TEXT_SIZE);
+    } else if (record[0] == SDL_TEXTEDITING && n_args >= 3 && n_args <= 5 && mp_obj_is_str(args[2])) {
+        SDL_utf8strlcpy((char *)&record[SDL2_RECORD_EDIT_TEXT], mp_obj_str_get_str(args[2]), SDL2_RECORD_EDIT_TEXT_SIZE);
+        for (size_t i = 3; i < n_args; i++) {
+            record[i - 1] = mp_obj_get_int(args[i]);
+        }
+    } else {
+        for (size_t i = 2; i < n_args; i++) {
+            record[i - 1] = mp_obj_get_int(args[i]);
+        }
+    }
+
+    // SDL only applies set_event_filter() to the events it generates
+    if (SDL_EventState(record[0], SDL_QUERY) == SDL_IGNORE) {
+        return mp_const_false;
+    }
+
+    sdl2_record_event(self, record, &event);
+    int pushed = SDL_PushEvent(&event);
+    if (pushed < 0) {
+        sdl2_check("SDL_PushEvent");
+    }
+    return mp_obj_new_bool(pushed);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_push_event_obj, 2, 9, sdl2_push_event);
+
+/// ### push_events()
+///
+/// ```python
+/// SDL2.push_events(buffer, count=None)
+/// ```
+///
+/// #### Description
+///
+/// Adds the events held in a buffer of poll_into() records to the queue in
+/// bulk. The RECORD_TIMESTAMP and RECORD_DEQUEUE_TIME items are ignored.
+/// Stops early if the queue is full. Records of type 0 (SDL_FIRSTEVENT), and
+/// events of types that set_event_filter() or stop_text_input() ignore, are
+/// skipped and not counted.
+///
+/// #### Parameters
+///
+/// - `buffer` array('i') or other buffer of RECORD_SIZE 32 bit integer records
+/// - `count` number of records to push from the start of the buffer, such as
+///    the value returned by poll_into(), or None for every record that fits
+///    in the buffer. Default: None
+///
+/// #### Returns:
+///
+/// - number of events added to the queue
+///
+/// #### Raises
+///
+/// - ValueError if the buffer is not 4 byte aligned or count is larger than
+///    the number of records it holds.
+/// - RuntimeError for any SDL2 errors.
+
+static mp_obj_t sdl2_push_events(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    sdl2_get_records(args[1], &bufinfo, MP_BUFFER_READ);
+
+    const int32_t *record = bufinfo.buf;
+    size_t remaining = bufinfo.len / (SDL2_RECORD_SIZE * sizeof(int32_t));
+    if (n_args > 2 && args[2] != mp_const_none) {
+        mp_int_t records = mp_obj_get_int(args[2]);
+        if (records < 0 || (size_t)records > remaining) {
+            mp_raise_ValueError(MP_ERROR_TEXT("count out of range"));
+        }
+        remaining = records;
+    }
+    size_t count = 0;
+    SDL_Event events[SDL2_PEEP_EVENTS];
+
+    while (remaining > 0) {
+        int chunk = 0;
+        while (remaining > 0 && chunk < SDL2_PEEP_EVENTS) {
+            // skip unused records and the types set_event_filter() ignores,
+            // as push_event() does
+            if (record[0] != SDL_FIRSTEVENT && SDL_EventState(record[0], SDL_QUERY) != SDL_IGNORE) {
+                sdl2_record_event(self, record, &events[chunk++]);
+            }
+            record += SDL2_RECORD_SIZE;
+            remaining--;
+        }
+        if (chunk == 0) {
+            break;
+        }
+
+        int added = SDL_PeepEvents(events, chunk, SDL_ADDEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+        if (added < 0) {
+            sdl2_check("SDL_PeepEvents");
+        }
+        count += added;
+        if (added < chunk) {
+            break;
+        }
+    }
+    return mp_obj_new_int(count);
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_push_events_obj, 2, 3, sdl2_push_events);
+
+/// ### keyboard_state()
+///
+/// ```python
+/// SDL2.keyboard_state()
+/// ```
+///
+/// #### Description
+///
+/// Returns a read-only memoryview of SDL's keyboard state, one byte per
+/// SDL_SCANCODE_* value, 1 if the key is pressed. The memoryview refers to
+/// SDL's own array, it is updated whenever events are polled and the same
+/// object is returned by every call.
+///
+/// #### Returns:
+///
+/// - memoryview indexed by scancode
+
+static mp_obj_t sdl2_keyboard_state(mp_obj_t self_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->keyboard_state == MP_OBJ_NULL) {
+        int numkeys;
+        const Uint8 *state = SDL_GetKeyboardState(&numkeys);
+        self->keyboard_state = mp_obj_new_memoryview('B', numkeys, (void *)state);
+    }
+    return self->keyboard_state;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_keyboard_state_obj, sdl2_keyboard_state);
+
+/// ### mouse_state()
+///
+/// ```python
+/// SDL2.mouse_state()
+/// ```
+///
+/// #### Description
+///
+/// Returns the current position of the mouse in virtual pixels and the
+/// state of its buttons as of the last time events were polled.
+///
+/// #### Returns:
+///
+/// - tuple (x, y, buttons), test buttons with the SDL_BUTTON_*MASK constants
+
+static mp_obj_t sdl2_mouse_state(mp_obj_t self_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    int x, y;
+    Uint32 buttons = SDL_GetMouseState(&x, &y);
+
+    mp_obj_t state[3] = {
+        mp_obj_new_int(x / self->x_scale),
+        mp_obj_new_int(y / self->y_scale),
+        mp_obj_new_int(buttons)
+    };
+    return mp_obj_new_tuple(3, state);
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_mouse_state_obj, sdl2_mouse_state);
+
+/// ### set_event_filter()
+///
+/// ```python
+/// SDL2.set_event_filter(types=None)
+/// ```
+///
+/// #### Description
+///
+/// Only queue events of the given types. SDL drops events of the other
+/// standard types before they reach the queue, so they cost nothing to poll.
+/// The filter is global to SDL and applies to all SDL2 objects. User event
+/// types are never filtered, and SDL_SYSWMEVENT stays disabled unless given.
+/// start_text_input() and stop_text_input() turn SDL_TEXTINPUT and
+/// SDL_TEXTEDITING on and off themselves, overriding the filter for those
+/// types, so call set_event_filter() again after them if needed.
+///
+/// #### Parameters
+///
+/// - `types` list or tuple of event types to deliver, for example
+///    (sdl2.SDL_QUIT,), or None to restore the event types delivered before
+///    the first filter was set. Default: None
+
+// Standard event types set_event_filter() can ignore. SDL_SYSWMEVENT is left
+// out, SDL keeps it disabled unless asked for.
+static const Uint32 sdl2_event_types[] = {
+    SDL_QUIT,
+    SDL_APP_TERMINATING, SDL_APP_LOWMEMORY,
+    SDL_APP_WILLENTERBACKGROUND, SDL_APP_DIDENTERBACKGROUND,
+    SDL_APP_WILLENTERFOREGROUND, SDL_APP_DIDENTERFOREGROUND,
+    #if SDL_VERSION_ATLEAST(2, 0, 14)
+    SDL_LOCALECHANGED,
+    #endif
+    #if SDL_VERSION_ATLEAST(2, 0, 9)
+    SDL_DISPLAYEVENT,
+    #endif
+    SDL_WINDOWEVENT,
+    SDL_KEYDOWN, SDL_KEYUP, SDL_TEXTEDITING, SDL_TEXTINPUT, SDL_KEYMAPCHANGED,
+    #if SDL_VERSION_ATLEAST(2, 0, 22)
+    SDL_TEXTEDITING_EXT,
+    #endif
+    SDL_MOUSEMOTION, SDL_MOUSEBUTTONDOWN, SDL_MOUSEBUTTONUP, SDL_MOUSEWHEEL,
+    SDL_JOYAXISMOTION, SDL_JOYBALLMOTION, SDL_JOYHATMOTION, SDL_JOYBUTTONDOWN, SDL_JOYBUTTONUP,
+    SDL_JOYDEVICEADDED, SDL_JOYDEVICEREMOVED,
+    #if SDL_VERSION_ATLEAST(2, 24, 0)
+    SDL_JOYBATTERYUPDATED,
+    #endif
+    SDL_CONTROLLERAXISMOTION, SDL_CONTROLLERBUTTONDOWN, SDL_CONTROLLERBUTTONUP,
+    SDL_CONTROLLERDEVICEADDED, SDL_CONTROLLERDEVICEREMOVED, SDL_CONTROLLERDEVICEREMAPPED,
+    #if SDL_VERSION_ATLEAST(2, 0, 14)
+    SDL_CONTROLLERTOUCHPADDOWN, SDL_CONTROLLERTOUCHPADMOTION, SDL_CONTROLLERTOUCHPADUP,
+    SDL_CONTROLLERSENSORUPDATE,
+    #endif
+    SDL_FINGERDOWN, SDL_FINGERUP, SDL_FINGERMOTION,
+    SDL_DOLLARGESTURE, SDL_DOLLARRECORD, SDL_MULTIGESTURE,
+    SDL_CLIPBOARDUPDATE,
+    SDL_DROPFILE, SDL_DROPTEXT, SDL_DROPBEGIN, SDL_DROPCOMPLETE,
+    SDL_AUDIODEVICEADDED, SDL_AUDIODEVICEREMOVED,
+    #if SDL_VERSION_ATLEAST(2, 0, 9)
+    SDL_SENSORUPDATE,
+    #endif
+    SDL_RENDER_TARGETS_RESET, SDL_RENDER_DEVICE_RESET,
+};
+
+// state of each type before the first filter was set, restored by None
+static Uint8 sdl2_event_states[MP_ARRAY_SIZE(sdl2_event_types)];
+static bool sdl2_event_states_saved = false;
+
+static mp_obj_t sdl2_set_event_filter(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t types_in = n_args > 1 ? args[1] : mp_const_none;
+
+    if (types_in == mp_const_none) {
+        if (sdl2_event_states_saved) {
+            for (size_t i = 0; i < MP_ARRAY_SIZE(sdl2_event_types); i++) {
+                SDL_EventState(sdl2_event_types[i], sdl2_event_states[i]);
+            }
+            sdl2_event_states_saved = false;
+        }
+        return mp_const_none;
+    }
 
-} sdl2_obj_t;
+    size_t len;
+    mp_obj_t *types;
+    mp_obj_get_array(types_in, &len, &types);
 
-/// ### SDL2
+    // check every item before changing anything
+    for (size_t i = 0; i < len; i++) {
+        mp_obj_get_int(types[i]);
+    }
+    if (!sdl2_event_states_saved) {
+        for (size_t i = 0; i < MP_ARRAY_SIZE(sdl2_event_types); i++) {
+            sdl2_event_states[i] = SDL_EventState(sdl2_event_types[i], SDL_QUERY);
+        }
+        sdl2_event_states_saved = true;
+    }
+    for (size_t i = 0; i < MP_ARRAY_SIZE(sdl2_event_types); i++) {
+        SDL_EventState(sdl2_event_types[i], SDL_IGNORE);
+    }
+    for (size_t i = 0; i < len; i++) {
+        SDL_EventState(mp_obj_get_int(types[i]), SDL_ENABLE);
+    }
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_set_event_filter_obj, 1, 2, sdl2_set_event_filter);
+
+/// ### open_controller()
 ///
 /// ```python
-/// sdl2.SDL2(
-///     width=320,
-///     height=240,
-///     x=SDL_WINDOWPOS_CENTERED,
-///     y=SDL_WINDOWPOS_CENTERED,
-///     title="MicroPython",
-///     window_flags=SDL_WINDOW_SHOWN,
-///     render_flags=SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC)
+/// SDL2.open_controller(index=0)
 /// ```
 ///
 /// #### Description
-/// Creates a window and renderer with the specified position, dimensions,
-/// title, flags and returns a SDL2 object.
 ///
-/// #### Parameters
-/// - `width` The width of the window. Default: 320
-/// - `height` The height of the window. Default: 240
-/// - `x` The x position of the window. Default: SDL_WINDOWPOS_CENTERED
-///    - SDL_WINDOWPOS_UNDEFINED - used to indicate that you don't care what the x position is
-///    - SDL_WINDOWPOS_CENTERED - used to indicate that the window position should be centered
+/// Opens a game controller so it produces SDL_CONTROLLER* events. SDL sends
+/// a SDL_CONTROLLERDEVICEADDED event with the index of each controller that
+/// is connected at startup or plugged in later. Up to 4 controllers can be
+/// open at the same time.
 ///
-/// - `y` The y position of the window. Default: SDL_WINDOWPOS_CENTERED
-///    - SDL_WINDOWPOS_UNDEFINED - used to indicate that you don't care what the y position is
-///    - SDL_WINDOWPOS_CENTERED - used to indicate that the window position should be centered
+/// #### Parameters
 ///
-/// - `x_scale` The x scale of the window. Default: 1
-/// - `y_scale` The y scale of the window. Default: 1
-/// - `title` The title of the window. Default: "MicroPython"
-/// - `window_flags` The window flags. Default: SDL_WINDOW_SHOWN
-///    - SDL_WINDOW_SHOWN - the window is visible
-///    - SDL_WINDOW_BORDERLESS - no window decoration
+/// - `index` device index of the controller, 0 to the number of joysticks - 1
 ///
-/// - `render_flags` The render flags. Default: SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC
-///    - SDL_RENDERER_ACCELERATED - the renderer uses hardware acceleration
-///    - SDL_RENDERER_PRESENTVSYNC - present is synchronized with the refresh rate
+/// #### Returns:
 ///
-/// #### Returns
-/// - A new SDL2 object.
+/// - instance id of the controller, used by the `which` item of its events
 ///
 /// #### Raises
+///
+/// - ValueError if the device is not a game controller.
 /// - RuntimeError for any SDL2 errors.
 
-static mp_obj_t sdl2_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *all_args)
-{
-	enum
-	{
-		ARG_width,              // The width of the window in virtual pixels
-		ARG_height,             // The height of the window in virtual pixels
-		ARG_x,                  // The x position of the window in virtual pixels
-		ARG_y,                  // The y position of the window in virtual pixels
-        ARG_x_scale,            // The x scale of the window
-        ARG_y_scale,            // The y scale of the window
-		ARG_title,              // The title of the window
-		ARG_window_flags,       // The window flags
-        ARG_render_flags,       // The render flags
-	};
-
-	static const mp_arg_t allowed_args[] = {
-		{MP_QSTR_width, MP_ARG_INT, {.u_int = 320}},
-		{MP_QSTR_height, MP_ARG_INT, {.u_int = 240}},
-		{MP_QSTR_x, MP_ARG_OBJ, {.u_int = SDL_WINDOWPOS_CENTERED}},
-		{MP_QSTR_y, MP_ARG_OBJ, {.u_int = SDL_WINDOWPOS_CENTERED}},
-        {MP_QSTR_x_scale, MP_ARG_INT, {.u_int = 1}},
-        {MP_QSTR_y_scale, MP_ARG_INT, {.u_int = 1}},
-		{MP_QSTR_title, MP_ARG_OBJ, {.u_rom_obj = MP_ROM_QSTR(MP_QSTR_MicroPython)}},
-		{MP_QSTR_window_flags, MP_ARG_INT, {.u_int = SDL_WINDOW_SHOWN}},
-        {MP_QSTR_render_flags, MP_ARG_INT, {.u_int = SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC}},
-	};
+static mp_obj_t sdl2_open_controller(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t index = n_args > 1 ? mp_obj_get_int(args[1]) : 0;
 
-	mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
-	mp_arg_parse_all_kw_array(n_args, n_kw, all_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+    if (index < 0 || index >= SDL_NumJoysticks() || !SDL_IsGameController(index)) {
+        mp_raise_ValueError(MP_ERROR_TEXT("not a game controller"));
+    }
 
-	// Allocates the new object and sets the type.
-	sdl2_obj_t *self = mp_obj_malloc(sdl2_obj_t, type);
+    size_t slot = 0;
+    while (slot < SDL2_MAX_CONTROLLERS && self->controllers[slot]) {
+        slot++;
+    }
+    if (slot == SDL2_MAX_CONTROLLERS) {
+        mp_raise_msg(&mp_type_RuntimeError, MP_ERROR_TEXT("too many controllers open"));
+    }
 
-	// store the argument values in the object
-	self->x = args[ARG_x].u_int;
-	self->y = args[ARG_y].u_int;
-	self->width = args[ARG_width].u_int;
-	self->height = args[ARG_height].u_int;
-    self->x_scale = args[ARG_x_scale].u_int;
-    self->y_scale = args[ARG_y_scale].u_int;
-	self->title = mp_obj_str_get_str(args[ARG_title].u_obj);
-	self->window_flags = args[ARG_window_flags].u_int;
-    self->render_flags = args[ARG_render_flags].u_int;
+    SDL_GameController *controller = SDL_GameControllerOpen(index);
+    if (controller == NULL) {
+        sdl2_check("SDL_GameControllerOpen");
+    }
+    self->controllers[slot] = controller;
+    return mp_obj_new_int(SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller)));
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_open_controller_obj, 1, 2, sdl2_open_controller);
 
-	if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
-		mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_Init error: %s\n"), SDL_GetError());
-	}
+// Find the open_controller() slot of a controller instance id, -1 if not open
+static int sdl2_find_controller(sdl2_obj_t *self, mp_obj_t which_in) {
+    SDL_JoystickID which = mp_obj_get_int(which_in);
 
-	self->win = SDL_CreateWindow(
-                    self->title,
-                    self->x,
-                    self->y,
-                    self->width * self->x_scale,
-                    self->height * self->y_scale,
-                    self->window_flags);
+    for (int slot = 0; slot < SDL2_MAX_CONTROLLERS; slot++) {
+        if (self->controllers[slot] && SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(self->controllers[slot])) == which) {
+            return slot;
+        }
+    }
+    return -1;
+}
 
-	if (self->win == NULL) {
-		mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_CreateWindow error: %s\n"), SDL_GetError());
-	}
+/// ### close_controller()
+///
+/// ```python
+/// SDL2.close_controller(which)
+/// ```
+///
+/// #### Description
+///
+/// Closes a controller opened by open_controller(), does nothing if it is not
+/// open.
+///
+/// #### Parameters
+///
+/// - `which` instance id returned by open_controller()
 
-	self->renderer = SDL_CreateRenderer(self->win, -1, self->render_flags);
-	if (self->renderer == NULL) {
-		mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_CreateRenderer error: %s\n"), SDL_GetError());
-	}
+static mp_obj_t sdl2_close_controller(mp_obj_t self_in, mp_obj_t which_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+    int slot = sdl2_find_controller(self, which_in);
 
-	return MP_OBJ_FROM_PTR(self);
+    if (slot >= 0) {
+        SDL_GameControllerClose(self->controllers[slot]);
+        self->controllers[slot] = NULL;
+    }
+    return mp_const_none;
 }
+static MP_DEFINE_CONST_FUN_OBJ_2(sdl2_close_controller_obj, sdl2_close_controller);
 
-/// ### show
+/// ### controller_state()
 ///
 /// ```python
-/// SDL2.show(buffer)
+/// SDL2.controller_state(which, buffer=None)
 /// ```
+///
 /// #### Description
 ///
-/// Show the buffer on the SDL2 window.
+/// Reads the position of every axis and the state of every button of a
+/// controller in one call, as of the last time events were polled. The
+/// state is written as 16 bit integers, CONTROLLER_AXES axes indexed by
+/// SDL_CONTROLLER_AXIS_* followed by CONTROLLER_BUTTONS buttons at
+/// CONTROLLER_AXES + SDL_CONTROLLER_BUTTON_*, 1 if pressed.
 ///
 /// #### Parameters
 ///
-/// - `buffer` bytearray of 16-bit RGB565 values
+/// - `which` instance id returned by open_controller()
+/// - `buffer` array('h') or other writable buffer of at least
+///    CONTROLLER_AXES + CONTROLLER_BUTTONS 16 bit integers to reuse, or None
+///    to allocate a new memoryview of 'h' items. Default: None
+///
+/// #### Returns:
+///
+/// - the buffer holding the state
 ///
 /// #### Raises
 ///
-/// - ValueError if the buffer is the wrong size.
-/// - RuntimeError for any SDL2 errors.
+/// - ValueError if the controller is not open or the buffer is too small.
 
-static mp_obj_t sdl2_show(size_t n_args, const mp_obj_t *args) {
-	sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-	mp_buffer_info_t bufinfo;
-	mp_get_buffer(args[1], &bufinfo, MP_BUFFER_READ);
+static mp_obj_t sdl2_controller_state(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    int slot = sdl2_find_controller(self, args[1]);
+    size_t items = SDL_CONTROLLER_AXIS_MAX + SDL_CONTROLLER_BUTTON_MAX;
+    size_t size = items * sizeof(Sint16);
 
-    // Check that there is a buffer.
-    if (bufinfo.buf == NULL) {
-        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("no buffer"));
+    if (slot < 0) {
+        mp_raise_ValueError(MP_ERROR_TEXT("controller not open"));
     }
 
-    // Check the buffer size.
-    if (bufinfo.len != (unsigned) self->width * self->height * 2) {
-        mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("buffer size mismatch"));
+    mp_obj_t buffer_in = n_args > 2 ? args[2] : mp_const_none;
+    if (buffer_in == mp_const_none) {
+        // a writable memoryview of 'h' items, so indexing gives the values
+        buffer_in = mp_obj_new_memoryview('h' | MP_OBJ_ARRAY_TYPECODE_FLAG_RW, items, m_new(Sint16, items));
     }
 
-	uint16_t *buffer = bufinfo.buf;
-    SDL_Rect fillRect;
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buffer_in, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.len < size) {
+        mp_raise_ValueError(MP_ERROR_TEXT("buffer too small"));
+    }
 
-	int i = 0;
-	for (int y = 0; y < self->height; y++) {
-		for (int x = 0; x < self->width; x++) {
-			uint16_t color = buffer[i++];
-			unsigned int r = (color >> 11) * 255 / 31;
-			unsigned int g = ((color >> 5) & 0x3F) * 255 / 63;
-			unsigned int b = (color & 0x1F) * 255 / 31;
+    SDL_GameController *controller = self->controllers[slot];
+    Sint16 *state = bufinfo.buf;
+    for (int axis = 0; axis < SDL_CONTROLLER_AXIS_MAX; axis++) {
+        *state++ = SDL_GameControllerGetAxis(controller, axis);
+    }
+    for (int button = 0; button < SDL_CONTROLLER_BUTTON_MAX; button++) {
+        *state++ = SDL_GameControllerGetButton(controller, button);
+    }
+    return buffer_in;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_controller_state_obj, 2, 3, sdl2_controller_state);
 
-            if (SDL_SetRenderDrawColor(self->renderer, r, g, b, 255) != 0) {
-                mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_SetRenderDrawColor error: %s\n"), SDL_GetError());
-            }
+/// ### start_text_input()
+///
+/// ```python
+/// SDL2.start_text_input()
+/// ```
+///
+/// #### Description
+///
+/// Start producing SDL_TEXTINPUT and SDL_TEXTEDITING events, which hold the
+/// text typed using the keyboard layout and input method. On some platforms
+/// text input is on when SDL starts.
 
-            if (self->x_scale == 1 && self->y_scale == 1) {
-                if (SDL_RenderDrawPoint(self->renderer, x, y) != 0) {
-                    mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_RenderDrawPoint error: %s\n"), SDL_GetError());
-                }
-                continue;
-            }
+static mp_obj_t sdl2_start_text_input(mp_obj_t self_in) {
+    SDL_StartTextInput();
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_start_text_input_obj, sdl2_start_text_input);
 
-            fillRect.x = x * self->x_scale;
-            fillRect.y = y * self->y_scale;
-            fillRect.w = self->x_scale;
-            fillRect.h = self->y_scale;
-            if (SDL_RenderFillRect(self->renderer, &fillRect) != 0) {
-                mp_raise_msg_varg(&mp_type_RuntimeError, MP_ERROR_TEXT("SDL_RenderFillRect error: %s\n"), SDL_GetError());
-            }
-		}
-	}
+/// ### stop_text_input()
+///
+/// ```python
+/// SDL2.stop_text_input()
+/// ```
+///
+/// #### Description
+///
+/// Stop producing SDL_TEXTINPUT and SDL_TEXTEDITING events.
 
-	SDL_RenderPresent(self->renderer);
-	return mp_const_none;
+static mp_obj_t sdl2_stop_text_input(mp_obj_t self_in) {
+    SDL_StopTextInput();
+    return mp_const_none;
 }
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_show_obj, 1, 2, sdl2_show);
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_stop_text_input_obj, sdl2_stop_text_input);
 
-/// ### event
+/// ### record_events()
 ///
 /// ```python
-/// SDL2.event()
+/// SDL2.record_events(filename=None)
 /// ```
 ///
 /// #### Description
 ///
-/// Checks for events and returns a tuple describing the event if there is one,
-/// otherwise returns None.
+/// Writes every event taken from the queue by poll_event(), wait_event(),
+/// poll_events() or poll_into() to a binary file, with the number of times
+/// show() was called since recording started. The file can be replayed by
+/// replay_events() on the same platform and SDL version.
 ///
-/// #### Returns:
+/// #### Parameters
 ///
-/// - None or a tuple describing the event
+/// - `filename` file to record to, replaced if it exists, or None to stop
+///    recording and close the file.
 ///
-/// #### Event Types:
+/// #### Raises
+///
+/// - OSError if the file can not be written. If an event can not be written
+///    recording stops, the event is still delivered and the next call to
+///    record_events() raises.
 
-static mp_obj_t sdl2_poll_event(size_t n_args, const mp_obj_t *args) {
+static mp_obj_t sdl2_record_events(size_t n_args, const mp_obj_t *args) {
     sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
-  	SDL_Event event;
-    const char *keyname = "";
 
-	if (SDL_PollEvent(&event)) {
+    if (!sdl2_record_close(self)) {
+        mp_raise_OSError(MP_EIO);
+    }
+    if (n_args < 2 || args[1] == mp_const_none) {
+        return mp_const_none;
+    }
 
-		switch(event.type) {
-			case SDL_KEYDOWN:
-			case SDL_KEYUP:
-
-                ///   - SDL_KEYDOWN or SDL_KEYUP
-                ///
-                ///     (event_type, keyname, mod)
-                ///
-                ///     Index       | Item       | Description
-                ///     ------------|------------|------------
-                ///     sdl.EVENT   | event_type | SDL_KEYDOWN or SDL_KEYUP
-                ///     sdl.KEYNAME | keyname    | name of the key pressed or released if any
-                ///     sdl.MOD     | mod        | status of modifier keys (shift, ctrl, alt, etc.)
-
-				keyname = SDL_GetKeyName(event.key.keysym.sym);
-				mp_obj_t result[3] = {
-					mp_obj_new_int(event.type),
-					mp_obj_new_str(keyname, strlen(keyname)),
-					mp_obj_new_int(event.key.keysym.mod)
-				};
-				return mp_obj_new_tuple(3, result);
-
-			case SDL_MOUSEMOTION:
-
-                ///   - SDL_MOUSEMOTION
-                ///
-                ///     (event_type, x, y, xrel, yrel, state)
-                ///
-                ///      Index       | Item       | Description
-                ///     -------------|------------|------------
-                ///      sdl.EVENT   | event_type | SDL_MOUSEMOTION
-                ///      sdl.X       | x          | coordinates of the mouse
-                ///      sdl.Y       | y          | coordinates of the mouse
-                ///      sdl.XREL    | xrel       | relative motion in the X direction
-                ///      sdl.YREL    | yrel       | relative motion in the Y direction
-                ///      sdl.STATE   | state      | state of the mouse buttons
-				{
-					mp_obj_t mouse_motion[6] = {
-						mp_obj_new_int(event.type),
-						mp_obj_new_int(event.motion.x / self->x_scale),
-						mp_obj_new_int(event.motion.y / self->y_scale),
-						mp_obj_new_int(event.motion.xrel / self->x_scale),
-						mp_obj_new_int(event.motion.yrel / self->y_scale),
-						mp_obj_new_int(event.motion.state)
-					};
-					return mp_obj_new_tuple(6, mouse_motion);
-				}
-
-			case SDL_MOUSEBUTTONDOWN:
-			case SDL_MOUSEBUTTONUP:
-
-                ///   - SDL_MOUSEBUTTONDOWN or SDL_MOUSEBUTTONUP
-                ///
-                ///     (event_type, x, y, button)
-                ///
-                ///     | Index       | Item       | Description
-                ///     |-------------|------------|------------
-                ///     | sdl.EVENT   | event_type | SDL_MOUSEBUTTONDOWN or SDL_MOUSEBUTTONUP
-                ///     | sdl.X       | x          | coordinates of the mouse
-                ///     | sdl.Y       | y          | coordinates of the mouse
-                ///     | sdl.BUTTON  | button     | button pressed or released
-				{
-					mp_obj_t mouse_button[4] = {
-						mp_obj_new_int(event.type),
-						mp_obj_new_int(event.button.x / self->x_scale),
-						mp_obj_new_int(event.button.y / self->y_scale),
-						mp_obj_new_int(event.button.button)
-					};
-					return mp_obj_new_tuple(4, mouse_button);
-				}
-
-			case SDL_MOUSEWHEEL:
-
-                ///   - SDL_MOUSEWHEEL
-                ///
-                ///     (event_type, x, y, direction, preciseX, preciseY, mouseX, mouseY)
-                ///
-                ///     | Index         | Item       | Description
-                ///     |---------------|------------|------------
-                ///     | sdl.EVENT     | event_type | SDL_MOUSEWHEEL
-                ///     | sdl.X         | x          | amount scrolled horizontally
-                ///     | sdl.Y         | y          | amount scrolled vertically
-                ///     | sdl.DIRECTION | direction  | direction of the scroll
-
-				{
-					mp_obj_t mouse_wheel[8] = {
-						mp_obj_new_int(event.type),
-						mp_obj_new_int(event.wheel.x / self->x_scale),
-						mp_obj_new_int(event.wheel.y / self->x_scale),
-						mp_obj_new_int(event.wheel.direction),
-					};
-					return mp_obj_new_tuple(8, mouse_wheel);
-				}
-		}
-
-        ///   - SDL_QUIT
-        ///
-        ///     | Index         | Item       | Description
-        ///     |---------------|------------|------------
-        ///     | sdl.EVENT     | event_type | SDL_QUIT
-        ///
-        ///   - all others return a tuple containing the integer (event_type) id of the event
-        ///
-        ///     | Index         | Item       | Description
-        ///     |---------------|------------|------------
-        ///     | sdl.EVENT     | event_type | integer event_type id
-
-		mp_obj_t event_type[1] = {
-			mp_obj_new_int(event.type)
-		};
-
-		return mp_obj_new_tuple(1, event_type);
-	}
-	else {
-		return mp_const_none;
-	}
+    FILE *file = fopen(mp_obj_str_get_str(args[1]), "wb");
+    if (file == NULL) {
+        mp_raise_OSError(errno);
+    }
+
+    uint32_t entry_size = sizeof(sdl2_event_entry_t);
+    if (fwrite(SDL2_EVENTS_MAGIC, 8, 1, file) != 1 || fwrite(&entry_size, sizeof(entry_size), 1, file) != 1) {
+        fclose(file);
+        mp_raise_OSError(MP_EIO);
+    }
+    self->record_file = file;
+    self->record_start = self->frames;
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_record_events_obj, 1, 2, sdl2_record_events);
+
+/// ### replay_events()
+///
+/// ```python
+/// SDL2.replay_events(filename=None)
+/// ```
+///
+/// #### Description
+///
+/// Pushes the events written by record_events() back into the queue, each
+/// one when show() has been called as many times as when it was recorded,
+/// so an application that polls once per frame sees the same input on the
+/// same frames. Only show() calls that get past their buffer and busy checks
+/// count as frames. Events recorded before the first show() are pushed at once.
+/// Input from the mouse and keyboard is still delivered while replaying.
+/// Replayed events do not change the state returned by keyboard_state(),
+/// mouse_state() or controller_state(), only code that handles the events
+/// sees them. For example, the pinball example reads its flippers from
+/// mouse_state(), so replay does not move them.
+///
+/// #### Parameters
+///
+/// - `filename` file written by record_events(), or None to stop replaying.
+///
+/// #### Raises
+///
+/// - OSError if the file can not be read.
+/// - ValueError if the file was not written by record_events() on this
+///    platform and SDL version.
+
+static mp_obj_t sdl2_replay_events(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    if (self->replay_file) {
+        fclose(self->replay_file);
+        self->replay_file = NULL;
+    }
+    if (n_args < 2 || args[1] == mp_const_none) {
+        return mp_const_none;
+    }
+
+    FILE *file = fopen(mp_obj_str_get_str(args[1]), "rb");
+    if (file == NULL) {
+        mp_raise_OSError(errno);
+    }
+
+    char magic[8];
+    uint32_t entry_size;
+    if (fread(magic, sizeof(magic), 1, file) != 1
+        || fread(&entry_size, sizeof(entry_size), 1, file) != 1
+        || memcmp(magic, SDL2_EVENTS_MAGIC, sizeof(magic)) != 0
+        || entry_size != sizeof(sdl2_event_entry_t)) {
+        fclose(file);
+        mp_raise_ValueError(MP_ERROR_TEXT("not a record_events file"));
+    }
+
+    self->replay_file = file;
+    self->replay_start = self->frames;
+    sdl2_replay_read(self);
+    sdl2_replay_due(self);
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_replay_events_obj, 1, 2, sdl2_replay_events);
+
+// Stop recording and replaying events
+static void sdl2_close_event_files(sdl2_obj_t *self) {
+    sdl2_record_close(self);
+    if (self->replay_file) {
+        fclose(self->replay_file);
+        self->replay_file = NULL;
+    }
 }
-static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_poll_event_obj, 1, 1, sdl2_poll_event);
 
 /// ### save()
 ///
@@ -365,10 +2668,11 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_poll_event_obj, 1, 1, sdl2_poll_
 /// ```
 /// #### Description
 ///
-/// Save the famebuf to a BMP file.
+/// Save the famebuf to a BMP file. Raises RuntimeError if another thread is
+/// in show().
 ///
 /// #### Parameters
-/// - framebuf: framebuf object
+/// - framebuf: framebuf object, buffer in the format given when the SDL2 object was created or the SDL2 object itself
 /// - filename: string
 ///
 /// #### Example
@@ -377,6 +2681,7 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_poll_event_obj, 1, 1, sdl2_poll_
 static mp_obj_t sdl2_save(size_t n_args, const mp_obj_t *args) {
     sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
 	mp_buffer_info_t bufinfo;
+    sdl2_check_idle(self);
 	mp_get_buffer(args[1], &bufinfo, MP_BUFFER_READ);
 
     // Check that there is a buffer.
@@ -385,26 +2690,47 @@ static mp_obj_t sdl2_save(size_t n_args, const mp_obj_t *args) {
     }
 
     // Check the buffer size.
-    if (bufinfo.len != (unsigned) self->width * self->height * 2) {
+    if (bufinfo.len != sdl2_buffer_size(self)) {
         mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("buffer size mismatch"));
     }
 
-    SDL_Surface* surface = SDL_CreateRGBSurfaceFrom(
-        bufinfo.buf,
-        self->width,
-        self->height,
-        16,
-        self->width * 2,
-        COLOR565_R,
-        COLOR565_G,
-        COLOR565_R,
-        0);
+    const char *filename = mp_obj_str_get_str(args[2]);
+    SDL_Surface *surface;
+
+    if (self->texture_format == SDL_PIXELFORMAT_RGB565 && !self->swap_bytes) {
+        surface = SDL_CreateRGBSurfaceFrom(
+            bufinfo.buf,
+            self->width,
+            self->height,
+            16,
+            self->width * 2,
+            COLOR565_R,
+            COLOR565_G,
+            COLOR565_B,
+            0);
+    } else {
+        // convert the buffer into a surface of the same format as the texture
+        surface = SDL_CreateRGBSurfaceWithFormat(
+            0,
+            self->width,
+            self->height,
+            self->texture_format == SDL_PIXELFORMAT_RGB565 ? 16 : 32,
+            self->texture_format);
+
+        if (surface != NULL) {
+            SDL_Rect rect = {0, 0, self->width, self->height};
+            sdl2_convert(self, bufinfo.buf, &rect, surface->pixels, surface->pitch);
+        }
+    }
 
     if (surface == NULL) {
         mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("could not create surface for save"));
     }
 
-    if (SDL_SaveBMP(surface, mp_obj_str_get_str(args[2])) != 0) {
+    int result = SDL_SaveBMP(surface, filename);
+    SDL_FreeSurface(surface);
+
+    if (result != 0) {
         mp_raise_msg(&mp_type_ValueError, MP_ERROR_TEXT("could not save surface"));
     }
     return mp_const_none;
@@ -412,6 +2738,84 @@ static mp_obj_t sdl2_save(size_t n_args, const mp_obj_t *args) {
 
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_save_obj, 3, 3, sdl2_save);
 
+/// ### set_palette()
+///
+/// ```python
+/// SDL2.set_palette(palette, start=0, format=RGB565)
+/// ```
+/// #### Description
+///
+/// Set the colors used to display the pixel values of the GS8, GS4_HMSB,
+/// GS2_HMSB and MONO formats, turning them into indexed color formats. The
+/// pixel value is used as an index into the palette, which defaults to a
+/// grayscale ramp. Only the palette is converted, so changing colors costs a
+/// palette upload and a show() instead of redrawing the buffer.
+///
+/// #### Parameters
+/// - `palette` buffer of up to 256 colors
+/// - `start` index of the first palette entry to set. Default: 0
+/// - `format` format of the colors in the buffer. Default: RGB565
+///    - RGB565 - 2 bytes per color in the same byte order as the buffer
+///    - RGB888 - 3 bytes per color, red first
+///
+/// #### Raises
+///
+/// - ValueError if the palette does not fit in the 256 entries.
+/// - RuntimeError if another thread is in show().
+
+static mp_obj_t sdl2_set_palette(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_self, ARG_palette, ARG_start, ARG_format };
+    static const mp_arg_t allowed_args[] = {
+        {MP_QSTR_, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+        {MP_QSTR_palette, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL}},
+        {MP_QSTR_start, MP_ARG_INT, {.u_int = 0}},
+        {MP_QSTR_format, MP_ARG_KW_ONLY | MP_ARG_INT, {.u_int = FRAMEBUF_RGB565}},
+    };
+
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[ARG_self].u_obj);
+    sdl2_check_idle(self);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[ARG_palette].u_obj, &bufinfo, MP_BUFFER_READ);
+
+    mp_int_t start = args[ARG_start].u_int;
+    mp_int_t format = args[ARG_format].u_int;
+    size_t entry_size;
+
+    if (format == FRAMEBUF_RGB565) {
+        entry_size = 2;
+    } else if (format == PALETTE_RGB888) {
+        entry_size = 3;
+    } else {
+        mp_raise_ValueError(MP_ERROR_TEXT("invalid palette format"));
+    }
+
+    size_t count = bufinfo.len / entry_size;
+    if (start < 0 || start + count > 256) {
+        mp_raise_ValueError(MP_ERROR_TEXT("palette too large"));
+    }
+
+    const uint8_t *src = bufinfo.buf;
+    uint32_t *lut = self->index_lut + start;
+
+    for (size_t i = 0; i < count; i++, src += entry_size) {
+        if (entry_size == 2) {
+            lut[i] = self->rgb565_lut[0][src[0]] | self->rgb565_lut[1][src[1]];
+        } else {
+            lut[i] = 0xff000000 | (src[0] << 16) | (src[1] << 8) | src[2];
+        }
+    }
+
+    // unchanged pixels may now have a different color
+    self->shadow_valid = false;
+
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_KW(sdl2_set_palette_obj, 2, sdl2_set_palette);
+
 /// ### deinit()
 ///
 /// ```python
@@ -419,20 +2823,121 @@ static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_save_obj, 3, 3, sdl2_save);
 /// ```
 /// #### Description
 ///
-/// Deinitialize SDL2, removes all SDL2 windows.
+/// Deinitialize SDL2, removes all SDL2 windows. Raises RuntimeError if another
+/// thread is in show().
 ///
 
 static mp_obj_t sdl2_deinit(size_t n_args, const mp_obj_t *args) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(args[0]);
+    sdl2_check_idle(self);
+
+    // The render thread destroys the renderer it created before exiting. Wait
+    // for it without the GIL, another thread's show() may hold its mutex.
+    MP_THREAD_GIL_EXIT();
+    sdl2_stop_render_thread(self);
+    MP_THREAD_GIL_ENTER();
+    sdl2_destroy_renderer(self);
+
+    for (int slot = 0; slot < SDL2_MAX_CONTROLLERS; slot++) {
+        if (self->controllers[slot]) {
+            SDL_GameControllerClose(self->controllers[slot]);
+            self->controllers[slot] = NULL;
+        }
+    }
+    sdl2_close_event_files(self);
+
+    if (self->win) {
+        SDL_DestroyWindow(self->win);
+        self->win = NULL;
+    }
     SDL_Quit();
     return mp_const_none;
 }
 static MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(sdl2_deinit_obj, 1, 1, sdl2_deinit);
 
+// Finaliser, frees the buffer once nothing, including a FrameBuffer using
+// the SDL2 object as its buffer, refers to the object.
+
+static mp_obj_t sdl2_del(mp_obj_t self_in) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    sdl2_stop_render_thread(self);
+    sdl2_close_event_files(self);
+    SDL_free(self->framebuffer);
+    self->framebuffer = NULL;
+    return mp_const_none;
+}
+static MP_DEFINE_CONST_FUN_OBJ_1(sdl2_del_obj, sdl2_del);
+
+/// ### asyncio
+///
+/// SDL2 objects can be registered with select.poll() and used with asyncio.
+/// An SDL2 object polls readable while events are waiting in the queue and
+/// writable once the last frame shown has been presented, see wait_idle().
+/// Polling pumps the SDL event loop, so it must be done from the thread that
+/// created the SDL2 object. See examples/display.py for next_event() and
+/// present() coroutines built on this.
+
+static mp_uint_t sdl2_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    sdl2_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (request != MP_STREAM_POLL) {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+
+    mp_uint_t ret = 0;
+    if (arg & MP_STREAM_POLL_RD) {
+        SDL_PumpEvents();
+        if (SDL_PeepEvents(NULL, 0, SDL_PEEKEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT) > 0) {
+            ret |= MP_STREAM_POLL_RD;
+        }
+    }
+    if (arg & MP_STREAM_POLL_WR) {
+        bool idle = true;
+        if (self->render_thread) {
+            MP_THREAD_GIL_EXIT();
+            SDL_LockMutex(self->lock);
+            idle = !self->frame_ready && !self->presenting;
+            SDL_UnlockMutex(self->lock);
+            MP_THREAD_GIL_ENTER();
+        }
+        if (idle) {
+            ret |= MP_STREAM_POLL_WR;
+        }
+    }
+    return ret;
+}
+
+static const mp_stream_p_t sdl2_stream_p = {
+    .ioctl = sdl2_ioctl,
+};
+
 static const mp_rom_map_elem_t sdl2_locals_dict_table[] = {
 	{MP_ROM_QSTR(MP_QSTR_show), MP_ROM_PTR(&sdl2_show_obj)},
+    {MP_ROM_QSTR(MP_QSTR_uploaded_bytes), MP_ROM_PTR(&sdl2_uploaded_bytes_obj)},
+    {MP_ROM_QSTR(MP_QSTR_last_present_time), MP_ROM_PTR(&sdl2_last_present_time_obj)},
+    {MP_ROM_QSTR(MP_QSTR_wait_idle), MP_ROM_PTR(&sdl2_wait_idle_obj)},
 	{MP_ROM_QSTR(MP_QSTR_poll_event), MP_ROM_PTR(&sdl2_poll_event_obj)},
+    {MP_ROM_QSTR(MP_QSTR_wait_event), MP_ROM_PTR(&sdl2_wait_event_obj)},
+    {MP_ROM_QSTR(MP_QSTR_poll_events), MP_ROM_PTR(&sdl2_poll_events_obj)},
+    {MP_ROM_QSTR(MP_QSTR_poll_into), MP_ROM_PTR(&sdl2_poll_into_obj)},
+    {MP_ROM_QSTR(MP_QSTR_push_event), MP_ROM_PTR(&sdl2_push_event_obj)},
+    {MP_ROM_QSTR(MP_QSTR_push_events), MP_ROM_PTR(&sdl2_push_events_obj)},
+    {MP_ROM_QSTR(MP_QSTR_keyboard_state), MP_ROM_PTR(&sdl2_keyboard_state_obj)},
+    {MP_ROM_QSTR(MP_QSTR_mouse_state), MP_ROM_PTR(&sdl2_mouse_state_obj)},
+    {MP_ROM_QSTR(MP_QSTR_set_event_filter), MP_ROM_PTR(&sdl2_set_event_filter_obj)},
+    {MP_ROM_QSTR(MP_QSTR_open_controller), MP_ROM_PTR(&sdl2_open_controller_obj)},
+    {MP_ROM_QSTR(MP_QSTR_close_controller), MP_ROM_PTR(&sdl2_close_controller_obj)},
+    {MP_ROM_QSTR(MP_QSTR_controller_state), MP_ROM_PTR(&sdl2_controller_state_obj)},
+    {MP_ROM_QSTR(MP_QSTR_start_text_input), MP_ROM_PTR(&sdl2_start_text_input_obj)},
+    {MP_ROM_QSTR(MP_QSTR_stop_text_input), MP_ROM_PTR(&sdl2_stop_text_input_obj)},
+    {MP_ROM_QSTR(MP_QSTR_record_events), MP_ROM_PTR(&sdl2_record_events_obj)},
+    {MP_ROM_QSTR(MP_QSTR_replay_events), MP_ROM_PTR(&sdl2_replay_events_obj)},
     {MP_ROM_QSTR(MP_QSTR_save), MP_ROM_PTR(&sdl2_save_obj)},
+    {MP_ROM_QSTR(MP_QSTR_set_palette), MP_ROM_PTR(&sdl2_set_palette_obj)},
     {MP_ROM_QSTR(MP_QSTR_deinit), MP_ROM_PTR(&sdl2_deinit_obj)},
+    {MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&sdl2_del_obj)},
 };
 
 static MP_DEFINE_CONST_DICT(sdl2_locals_dict, sdl2_locals_dict_table);
@@ -442,6 +2947,8 @@ MP_DEFINE_CONST_OBJ_TYPE(
 	MP_QSTR_SDL2,
 	MP_TYPE_FLAG_NONE,
 	make_new, sdl2_make_new,
+	buffer, sdl2_get_buffer,
+	protocol, &sdl2_stream_p,
 	locals_dict, &sdl2_locals_dict);
 
 // Define all properties of the module.
@@ -457,6 +2964,45 @@ static const mp_rom_map_elem_t sdl2_module_globals_table[] = {
     {MP_ROM_QSTR(MP_QSTR_SDL_RENDERER_ACCELERATED), MP_ROM_INT(SDL_RENDERER_ACCELERATED)},
     {MP_ROM_QSTR(MP_QSTR_SDL_RENDERER_PRESENTVSYNC), MP_ROM_INT(SDL_RENDERER_PRESENTVSYNC)},
 
+    // framebuf formats: format argument of SDL2
+    {MP_ROM_QSTR(MP_QSTR_MONO_VLSB), MP_ROM_INT(FRAMEBUF_MVLSB)},
+    {MP_ROM_QSTR(MP_QSTR_RGB565), MP_ROM_INT(FRAMEBUF_RGB565)},
+    {MP_ROM_QSTR(MP_QSTR_GS4_HMSB), MP_ROM_INT(FRAMEBUF_GS4_HMSB)},
+    {MP_ROM_QSTR(MP_QSTR_MONO_HLSB), MP_ROM_INT(FRAMEBUF_MHLSB)},
+    {MP_ROM_QSTR(MP_QSTR_MONO_HMSB), MP_ROM_INT(FRAMEBUF_MHMSB)},
+    {MP_ROM_QSTR(MP_QSTR_GS2_HMSB), MP_ROM_INT(FRAMEBUF_GS2_HMSB)},
+    {MP_ROM_QSTR(MP_QSTR_GS8), MP_ROM_INT(FRAMEBUF_GS8)},
+
+    // set_palette color format, in addition to RGB565
+    {MP_ROM_QSTR(MP_QSTR_RGB888), MP_ROM_INT(PALETTE_RGB888)},
+
+    // SDL_WINDOWEVENT: (TYPE, WINDOW_EVENT, DATA1, DATA2)
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT), MP_ROM_INT(SDL_WINDOWEVENT)},
+    {MP_ROM_QSTR(MP_QSTR_WINDOW_EVENT), MP_ROM_INT(1)},
+    {MP_ROM_QSTR(MP_QSTR_DATA1), MP_ROM_INT(2)},
+    {MP_ROM_QSTR(MP_QSTR_DATA2), MP_ROM_INT(3)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_SHOWN), MP_ROM_INT(SDL_WINDOWEVENT_SHOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_HIDDEN), MP_ROM_INT(SDL_WINDOWEVENT_HIDDEN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_EXPOSED), MP_ROM_INT(SDL_WINDOWEVENT_EXPOSED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_MOVED), MP_ROM_INT(SDL_WINDOWEVENT_MOVED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_RESIZED), MP_ROM_INT(SDL_WINDOWEVENT_RESIZED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_SIZE_CHANGED), MP_ROM_INT(SDL_WINDOWEVENT_SIZE_CHANGED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_MINIMIZED), MP_ROM_INT(SDL_WINDOWEVENT_MINIMIZED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_MAXIMIZED), MP_ROM_INT(SDL_WINDOWEVENT_MAXIMIZED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_RESTORED), MP_ROM_INT(SDL_WINDOWEVENT_RESTORED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_ENTER), MP_ROM_INT(SDL_WINDOWEVENT_ENTER)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_LEAVE), MP_ROM_INT(SDL_WINDOWEVENT_LEAVE)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_FOCUS_GAINED), MP_ROM_INT(SDL_WINDOWEVENT_FOCUS_GAINED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_FOCUS_LOST), MP_ROM_INT(SDL_WINDOWEVENT_FOCUS_LOST)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_WINDOWEVENT_CLOSE), MP_ROM_INT(SDL_WINDOWEVENT_CLOSE)},
+
+    // SDL_TEXTINPUT: (TYPE, TEXT), SDL_TEXTEDITING: (TYPE, TEXT, START, LENGTH)
+    {MP_ROM_QSTR(MP_QSTR_SDL_TEXTINPUT), MP_ROM_INT(SDL_TEXTINPUT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_TEXTEDITING), MP_ROM_INT(SDL_TEXTEDITING)},
+    {MP_ROM_QSTR(MP_QSTR_TEXT), MP_ROM_INT(1)},
+    {MP_ROM_QSTR(MP_QSTR_START), MP_ROM_INT(2)},
+    {MP_ROM_QSTR(MP_QSTR_LENGTH), MP_ROM_INT(3)},
+
 	// SDL_MOUSEMOTION: (TYPE, X, Y, XREL, YREL, STATE)
     {MP_ROM_QSTR(MP_QSTR_SDL_MOUSEMOTION), MP_ROM_INT(SDL_MOUSEMOTION)},
 	{MP_ROM_QSTR(MP_QSTR_X), MP_ROM_INT(1)},
@@ -473,6 +3019,11 @@ static const mp_rom_map_elem_t sdl2_module_globals_table[] = {
 	{MP_ROM_QSTR(MP_QSTR_SDL_BUTTON_MIDDLE), MP_ROM_INT(SDL_BUTTON_MIDDLE)},
 	{MP_ROM_QSTR(MP_QSTR_SDL_BUTTON_RIGHT), MP_ROM_INT(SDL_BUTTON_RIGHT)},
 
+    // mouse_state() buttons
+    {MP_ROM_QSTR(MP_QSTR_SDL_BUTTON_LMASK), MP_ROM_INT(SDL_BUTTON_LMASK)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_BUTTON_MMASK), MP_ROM_INT(SDL_BUTTON_MMASK)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_BUTTON_RMASK), MP_ROM_INT(SDL_BUTTON_RMASK)},
+
 	// SDL_MOUSEWHEEL: (TYPE, X, Y, DIRECTION, PRECISEX, PRECISEY, MOUSEX, MOUSEY)
 	{MP_ROM_QSTR(MP_QSTR_SDL_MOUSEWHEEL), MP_ROM_INT(SDL_MOUSEWHEEL)},
 	{MP_ROM_QSTR(MP_QSTR_SDL_MOUSEWHEEL_NORMAL), MP_ROM_INT(SDL_MOUSEWHEEL_NORMAL)},
@@ -489,6 +3040,8 @@ static const mp_rom_map_elem_t sdl2_module_globals_table[] = {
 	{MP_ROM_QSTR(MP_QSTR_TYPE), MP_ROM_INT(0)},
 	{MP_ROM_QSTR(MP_QSTR_KEYNAME), MP_ROM_INT(1)},
 	{MP_ROM_QSTR(MP_QSTR_MOD), MP_ROM_INT(2)},
+	{MP_ROM_QSTR(MP_QSTR_KEYCODE), MP_ROM_INT(1)},
+	{MP_ROM_QSTR(MP_QSTR_SCANCODE), MP_ROM_INT(3)},
 	{MP_ROM_QSTR(MP_QSTR_KMOD_NONE), MP_ROM_INT(KMOD_NONE)},
 	{MP_ROM_QSTR(MP_QSTR_KMOD_LSHIFT), MP_ROM_INT(KMOD_LSHIFT)},
 	{MP_ROM_QSTR(MP_QSTR_KMOD_RSHIFT), MP_ROM_INT(KMOD_RSHIFT)},
@@ -512,8 +3065,215 @@ static const mp_rom_map_elem_t sdl2_module_globals_table[] = {
 	{MP_ROM_QSTR(MP_QSTR_KMOD_RALT), MP_ROM_INT(KMOD_RALT)},
 	{MP_ROM_QSTR(MP_QSTR_KMOD_GUI), MP_ROM_INT(KMOD_GUI)},
 
+    // SDL_KEYDOWN, SDL_KEYUP with keycodes=True: (TYPE, KEYCODE, MOD, SCANCODE)
+    {MP_ROM_QSTR(MP_QSTR_SDLK_RETURN), MP_ROM_INT(SDLK_RETURN)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_ESCAPE), MP_ROM_INT(SDLK_ESCAPE)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_BACKSPACE), MP_ROM_INT(SDLK_BACKSPACE)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_TAB), MP_ROM_INT(SDLK_TAB)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_SPACE), MP_ROM_INT(SDLK_SPACE)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_DELETE), MP_ROM_INT(SDLK_DELETE)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_0), MP_ROM_INT(SDLK_0)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_1), MP_ROM_INT(SDLK_1)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_2), MP_ROM_INT(SDLK_2)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_3), MP_ROM_INT(SDLK_3)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_4), MP_ROM_INT(SDLK_4)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_5), MP_ROM_INT(SDLK_5)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_6), MP_ROM_INT(SDLK_6)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_7), MP_ROM_INT(SDLK_7)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_8), MP_ROM_INT(SDLK_8)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_9), MP_ROM_INT(SDLK_9)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_a), MP_ROM_INT(SDLK_a)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_b), MP_ROM_INT(SDLK_b)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_c), MP_ROM_INT(SDLK_c)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_d), MP_ROM_INT(SDLK_d)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_e), MP_ROM_INT(SDLK_e)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_f), MP_ROM_INT(SDLK_f)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_g), MP_ROM_INT(SDLK_g)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_h), MP_ROM_INT(SDLK_h)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_i), MP_ROM_INT(SDLK_i)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_j), MP_ROM_INT(SDLK_j)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_k), MP_ROM_INT(SDLK_k)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_l), MP_ROM_INT(SDLK_l)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_m), MP_ROM_INT(SDLK_m)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_n), MP_ROM_INT(SDLK_n)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_o), MP_ROM_INT(SDLK_o)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_p), MP_ROM_INT(SDLK_p)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_q), MP_ROM_INT(SDLK_q)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_r), MP_ROM_INT(SDLK_r)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_s), MP_ROM_INT(SDLK_s)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_t), MP_ROM_INT(SDLK_t)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_u), MP_ROM_INT(SDLK_u)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_v), MP_ROM_INT(SDLK_v)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_w), MP_ROM_INT(SDLK_w)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_x), MP_ROM_INT(SDLK_x)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_y), MP_ROM_INT(SDLK_y)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_z), MP_ROM_INT(SDLK_z)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F1), MP_ROM_INT(SDLK_F1)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F2), MP_ROM_INT(SDLK_F2)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F3), MP_ROM_INT(SDLK_F3)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F4), MP_ROM_INT(SDLK_F4)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F5), MP_ROM_INT(SDLK_F5)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F6), MP_ROM_INT(SDLK_F6)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F7), MP_ROM_INT(SDLK_F7)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F8), MP_ROM_INT(SDLK_F8)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F9), MP_ROM_INT(SDLK_F9)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F10), MP_ROM_INT(SDLK_F10)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F11), MP_ROM_INT(SDLK_F11)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_F12), MP_ROM_INT(SDLK_F12)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_HOME), MP_ROM_INT(SDLK_HOME)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_END), MP_ROM_INT(SDLK_END)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_PAGEUP), MP_ROM_INT(SDLK_PAGEUP)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_PAGEDOWN), MP_ROM_INT(SDLK_PAGEDOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_RIGHT), MP_ROM_INT(SDLK_RIGHT)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_LEFT), MP_ROM_INT(SDLK_LEFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_DOWN), MP_ROM_INT(SDLK_DOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_UP), MP_ROM_INT(SDLK_UP)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_LCTRL), MP_ROM_INT(SDLK_LCTRL)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_LSHIFT), MP_ROM_INT(SDLK_LSHIFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_LALT), MP_ROM_INT(SDLK_LALT)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_LGUI), MP_ROM_INT(SDLK_LGUI)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_RCTRL), MP_ROM_INT(SDLK_RCTRL)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_RSHIFT), MP_ROM_INT(SDLK_RSHIFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_RALT), MP_ROM_INT(SDLK_RALT)},
+    {MP_ROM_QSTR(MP_QSTR_SDLK_RGUI), MP_ROM_INT(SDLK_RGUI)},
+
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_A), MP_ROM_INT(SDL_SCANCODE_A)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_B), MP_ROM_INT(SDL_SCANCODE_B)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_C), MP_ROM_INT(SDL_SCANCODE_C)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_D), MP_ROM_INT(SDL_SCANCODE_D)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_E), MP_ROM_INT(SDL_SCANCODE_E)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F), MP_ROM_INT(SDL_SCANCODE_F)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_G), MP_ROM_INT(SDL_SCANCODE_G)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_H), MP_ROM_INT(SDL_SCANCODE_H)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_I), MP_ROM_INT(SDL_SCANCODE_I)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_J), MP_ROM_INT(SDL_SCANCODE_J)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_K), MP_ROM_INT(SDL_SCANCODE_K)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_L), MP_ROM_INT(SDL_SCANCODE_L)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_M), MP_ROM_INT(SDL_SCANCODE_M)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_N), MP_ROM_INT(SDL_SCANCODE_N)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_O), MP_ROM_INT(SDL_SCANCODE_O)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_P), MP_ROM_INT(SDL_SCANCODE_P)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_Q), MP_ROM_INT(SDL_SCANCODE_Q)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_R), MP_ROM_INT(SDL_SCANCODE_R)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_S), MP_ROM_INT(SDL_SCANCODE_S)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_T), MP_ROM_INT(SDL_SCANCODE_T)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_U), MP_ROM_INT(SDL_SCANCODE_U)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_V), MP_ROM_INT(SDL_SCANCODE_V)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_W), MP_ROM_INT(SDL_SCANCODE_W)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_X), MP_ROM_INT(SDL_SCANCODE_X)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_Y), MP_ROM_INT(SDL_SCANCODE_Y)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_Z), MP_ROM_INT(SDL_SCANCODE_Z)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_0), MP_ROM_INT(SDL_SCANCODE_0)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_1), MP_ROM_INT(SDL_SCANCODE_1)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_2), MP_ROM_INT(SDL_SCANCODE_2)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_3), MP_ROM_INT(SDL_SCANCODE_3)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_4), MP_ROM_INT(SDL_SCANCODE_4)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_5), MP_ROM_INT(SDL_SCANCODE_5)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_6), MP_ROM_INT(SDL_SCANCODE_6)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_7), MP_ROM_INT(SDL_SCANCODE_7)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_8), MP_ROM_INT(SDL_SCANCODE_8)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_9), MP_ROM_INT(SDL_SCANCODE_9)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_RETURN), MP_ROM_INT(SDL_SCANCODE_RETURN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_ESCAPE), MP_ROM_INT(SDL_SCANCODE_ESCAPE)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_BACKSPACE), MP_ROM_INT(SDL_SCANCODE_BACKSPACE)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_TAB), MP_ROM_INT(SDL_SCANCODE_TAB)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_SPACE), MP_ROM_INT(SDL_SCANCODE_SPACE)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_DELETE), MP_ROM_INT(SDL_SCANCODE_DELETE)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F1), MP_ROM_INT(SDL_SCANCODE_F1)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F2), MP_ROM_INT(SDL_SCANCODE_F2)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F3), MP_ROM_INT(SDL_SCANCODE_F3)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F4), MP_ROM_INT(SDL_SCANCODE_F4)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F5), MP_ROM_INT(SDL_SCANCODE_F5)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F6), MP_ROM_INT(SDL_SCANCODE_F6)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F7), MP_ROM_INT(SDL_SCANCODE_F7)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F8), MP_ROM_INT(SDL_SCANCODE_F8)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F9), MP_ROM_INT(SDL_SCANCODE_F9)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F10), MP_ROM_INT(SDL_SCANCODE_F10)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F11), MP_ROM_INT(SDL_SCANCODE_F11)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_F12), MP_ROM_INT(SDL_SCANCODE_F12)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_HOME), MP_ROM_INT(SDL_SCANCODE_HOME)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_END), MP_ROM_INT(SDL_SCANCODE_END)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_PAGEUP), MP_ROM_INT(SDL_SCANCODE_PAGEUP)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_PAGEDOWN), MP_ROM_INT(SDL_SCANCODE_PAGEDOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_RIGHT), MP_ROM_INT(SDL_SCANCODE_RIGHT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_LEFT), MP_ROM_INT(SDL_SCANCODE_LEFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_DOWN), MP_ROM_INT(SDL_SCANCODE_DOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_UP), MP_ROM_INT(SDL_SCANCODE_UP)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_LCTRL), MP_ROM_INT(SDL_SCANCODE_LCTRL)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_LSHIFT), MP_ROM_INT(SDL_SCANCODE_LSHIFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_LALT), MP_ROM_INT(SDL_SCANCODE_LALT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_LGUI), MP_ROM_INT(SDL_SCANCODE_LGUI)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_RCTRL), MP_ROM_INT(SDL_SCANCODE_RCTRL)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_RSHIFT), MP_ROM_INT(SDL_SCANCODE_RSHIFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_RALT), MP_ROM_INT(SDL_SCANCODE_RALT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_SCANCODE_RGUI), MP_ROM_INT(SDL_SCANCODE_RGUI)},
+
+    // SDL_CONTROLLERAXISMOTION: (TYPE, WHICH, AXIS, VALUE)
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLERAXISMOTION), MP_ROM_INT(SDL_CONTROLLERAXISMOTION)},
+    {MP_ROM_QSTR(MP_QSTR_WHICH), MP_ROM_INT(1)},
+    {MP_ROM_QSTR(MP_QSTR_AXIS), MP_ROM_INT(2)},
+    {MP_ROM_QSTR(MP_QSTR_VALUE), MP_ROM_INT(3)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_AXIS_LEFTX), MP_ROM_INT(SDL_CONTROLLER_AXIS_LEFTX)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_AXIS_LEFTY), MP_ROM_INT(SDL_CONTROLLER_AXIS_LEFTY)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_AXIS_RIGHTX), MP_ROM_INT(SDL_CONTROLLER_AXIS_RIGHTX)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_AXIS_RIGHTY), MP_ROM_INT(SDL_CONTROLLER_AXIS_RIGHTY)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_AXIS_TRIGGERLEFT), MP_ROM_INT(SDL_CONTROLLER_AXIS_TRIGGERLEFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_AXIS_TRIGGERRIGHT), MP_ROM_INT(SDL_CONTROLLER_AXIS_TRIGGERRIGHT)},
+
+    // SDL_CONTROLLERBUTTONDOWN, SDL_CONTROLLERBUTTONUP: (TYPE, WHICH, CONTROLLER_BUTTON, BUTTON_STATE)
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLERBUTTONDOWN), MP_ROM_INT(SDL_CONTROLLERBUTTONDOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLERBUTTONUP), MP_ROM_INT(SDL_CONTROLLERBUTTONUP)},
+    {MP_ROM_QSTR(MP_QSTR_CONTROLLER_BUTTON), MP_ROM_INT(2)},
+    {MP_ROM_QSTR(MP_QSTR_BUTTON_STATE), MP_ROM_INT(3)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_A), MP_ROM_INT(SDL_CONTROLLER_BUTTON_A)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_B), MP_ROM_INT(SDL_CONTROLLER_BUTTON_B)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_X), MP_ROM_INT(SDL_CONTROLLER_BUTTON_X)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_Y), MP_ROM_INT(SDL_CONTROLLER_BUTTON_Y)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_BACK), MP_ROM_INT(SDL_CONTROLLER_BUTTON_BACK)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_GUIDE), MP_ROM_INT(SDL_CONTROLLER_BUTTON_GUIDE)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_START), MP_ROM_INT(SDL_CONTROLLER_BUTTON_START)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_LEFTSTICK), MP_ROM_INT(SDL_CONTROLLER_BUTTON_LEFTSTICK)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_RIGHTSTICK), MP_ROM_INT(SDL_CONTROLLER_BUTTON_RIGHTSTICK)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_LEFTSHOULDER), MP_ROM_INT(SDL_CONTROLLER_BUTTON_LEFTSHOULDER)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_RIGHTSHOULDER), MP_ROM_INT(SDL_CONTROLLER_BUTTON_RIGHTSHOULDER)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_DPAD_UP), MP_ROM_INT(SDL_CONTROLLER_BUTTON_DPAD_UP)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_DPAD_DOWN), MP_ROM_INT(SDL_CONTROLLER_BUTTON_DPAD_DOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_DPAD_LEFT), MP_ROM_INT(SDL_CONTROLLER_BUTTON_DPAD_LEFT)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLER_BUTTON_DPAD_RIGHT), MP_ROM_INT(SDL_CONTROLLER_BUTTON_DPAD_RIGHT)},
+
+    // SDL_CONTROLLERDEVICEADDED, SDL_CONTROLLERDEVICEREMOVED, SDL_CONTROLLERDEVICEREMAPPED: (TYPE, WHICH)
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLERDEVICEADDED), MP_ROM_INT(SDL_CONTROLLERDEVICEADDED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLERDEVICEREMOVED), MP_ROM_INT(SDL_CONTROLLERDEVICEREMOVED)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_CONTROLLERDEVICEREMAPPED), MP_ROM_INT(SDL_CONTROLLERDEVICEREMAPPED)},
+
+    // controller_state() layout
+    {MP_ROM_QSTR(MP_QSTR_CONTROLLER_AXES), MP_ROM_INT(SDL_CONTROLLER_AXIS_MAX)},
+    {MP_ROM_QSTR(MP_QSTR_CONTROLLER_BUTTONS), MP_ROM_INT(SDL_CONTROLLER_BUTTON_MAX)},
+
+    // SDL_FINGERDOWN, SDL_FINGERUP, SDL_FINGERMOTION: (TYPE, X, Y, XREL, YREL, PRESSURE, FINGER_ID)
+    {MP_ROM_QSTR(MP_QSTR_SDL_FINGERDOWN), MP_ROM_INT(SDL_FINGERDOWN)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_FINGERUP), MP_ROM_INT(SDL_FINGERUP)},
+    {MP_ROM_QSTR(MP_QSTR_SDL_FINGERMOTION), MP_ROM_INT(SDL_FINGERMOTION)},
+    {MP_ROM_QSTR(MP_QSTR_PRESSURE), MP_ROM_INT(5)},
+    {MP_ROM_QSTR(MP_QSTR_FINGER_ID), MP_ROM_INT(6)},
+
+    // SDL_MULTIGESTURE: (TYPE, X, Y, D_THETA, D_DIST, NUM_FINGERS)
+    {MP_ROM_QSTR(MP_QSTR_SDL_MULTIGESTURE), MP_ROM_INT(SDL_MULTIGESTURE)},
+    {MP_ROM_QSTR(MP_QSTR_D_THETA), MP_ROM_INT(3)},
+    {MP_ROM_QSTR(MP_QSTR_D_DIST), MP_ROM_INT(4)},
+    {MP_ROM_QSTR(MP_QSTR_NUM_FINGERS), MP_ROM_INT(5)},
+
 	// SDL_QUIT: (TYPE)
 	{MP_ROM_QSTR(MP_QSTR_SDL_QUIT), MP_ROM_INT(SDL_QUIT)},
+
+    // last two items of every event tuple
+    {MP_ROM_QSTR(MP_QSTR_TIMESTAMP), MP_ROM_INT(-2)},
+    {MP_ROM_QSTR(MP_QSTR_DEQUEUE_TIME), MP_ROM_INT(-1)},
+
+    // poll_into() records
+    {MP_ROM_QSTR(MP_QSTR_RECORD_SIZE), MP_ROM_INT(SDL2_RECORD_SIZE)},
+    {MP_ROM_QSTR(MP_QSTR_RECORD_TIMESTAMP), MP_ROM_INT(SDL2_RECORD_TIMESTAMP)},
+    {MP_ROM_QSTR(MP_QSTR_RECORD_DEQUEUE_TIME), MP_ROM_INT(SDL2_RECORD_DEQUEUE_TIME)},
 };
 
 static MP_DEFINE_CONST_DICT(sdl2_module_globals, sdl2_module_globals_table);